@@ -145,6 +145,26 @@
 #     error "port: LoomBase"
 #   endif
 
+  /** Pointer compression.
+  ***
+  ***   Noun references are shifted by U3_OS_LoomShift bits, doubling the
+  ***   addressable loom with each bit (1 == 8GB).  Off by default, as
+  ***   images are not portable between settings.
+  **/
+#   ifndef U3_OS_LoomShift
+#     define U3_OS_LoomShift 0
+#   endif
+
+#   if U3_OS_LoomShift && !defined(__LP64__)
+#     error "port: LoomShift requires a 64-bit address space"
+#   endif
+
+    //  NB: loom offsets (u3_post) are 32-bit words; 8GB is the ceiling
+    //
+#   if U3_OS_LoomShift > 1
+#     error "port: LoomShift must be 0 or 1"
+#   endif
+
 
   /** Private C "extensions."
   ***
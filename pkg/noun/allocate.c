@@ -51,6 +51,22 @@ static void
 _box_count(c3_ws siz_ws) { }
 #endif
 
+//  with shifted references, every box (and so every noun) must start
+//  on an allocation granule
+//
+STATIC_ASSERT( (0 == (c3_wiseof(u3a_box) % u3a_walign)),
+               "box header alignment" );
+STATIC_ASSERT( (0 == (u3a_minimum % u3a_walign)),
+               "minimum box alignment" );
+
+/* _box_align(): round box size [siz_w] up to the allocation granule.
+*/
+static inline c3_w
+_box_align(c3_w siz_w)
+{
+  return (siz_w + (u3a_walign - 1)) & ~(c3_w)(u3a_walign - 1);
+}
+
 /* _box_slot(): select the right free list to search for a block.
 */
 static c3_w
@@ -379,27 +395,62 @@ u3a_sane(void)
 }
 #endif
 
-/* u3a_reflux(): dump 1K cells from the cell list into regular memory.
+/* _ca_reflux_list(): dump 1K boxes from [lis_p] into regular memory.
 */
-void
-u3a_reflux(void)
+static void
+_ca_reflux_list(u3p(u3a_fbox)* lis_p)
 {
   c3_w i_w;
 
-  for ( i_w = 0; u3R->all.cel_p && (i_w < 1024); i_w++ ) {
-    u3_post  cel_p = u3R->all.cel_p;
+  for ( i_w = 0; *lis_p && (i_w < 1024); i_w++ ) {
+    u3_post  cel_p = *lis_p;
     u3a_box* box_u = &(u3to(u3a_fbox, cel_p)->box_u);
 
-    u3R->all.cel_p = u3to(u3a_fbox, cel_p)->nex_p;
+    *lis_p = u3to(u3a_fbox, cel_p)->nex_p;
 
     // otherwise _box_free() will double-count it
     //
-    _box_count(-(u3a_minimum));
+    _box_count(-(c3_ws)box_u->siz_w);
     _box_free(box_u);
 
   }
 }
 
+/* _ca_reflux_any(): yes if there are cached cells or slab boxes.
+*/
+static c3_o
+_ca_reflux_any(void)
+{
+  c3_w i_w;
+
+  if ( u3R->all.cel_p ) {
+    return c3y;
+  }
+
+  for ( i_w = 0; i_w < u3a_slab_no; i_w++ ) {
+    if ( u3R->sab_p[i_w] ) {
+      return c3y;
+    }
+  }
+
+  return c3n;
+}
+
+/* u3a_reflux(): dump 1K cells (and slab boxes of each size) from the
+**               cell (and slab) lists into regular memory.
+*/
+void
+u3a_reflux(void)
+{
+  c3_w i_w;
+
+  _ca_reflux_list(&u3R->all.cel_p);
+
+  for ( i_w = 0; i_w < u3a_slab_no; i_w++ ) {
+    _ca_reflux_list(&u3R->sab_p[i_w]);
+  }
+}
+
 /* _ca_reclaim_half(): reclaim from memoization cache.
 */
 static void
@@ -433,7 +484,7 @@ _ca_reclaim_half(void)
 static void*
 _ca_willoc(c3_w len_w, c3_w ald_w, c3_w alp_w)
 {
-  c3_w siz_w = c3_max(u3a_minimum, u3a_boxed(len_w));
+  c3_w siz_w = _box_align(c3_max(u3a_minimum, u3a_boxed(len_w)));
   c3_w sel_w = _box_slot(siz_w);
 
   alp_w = (alp_w + c3_wiseof(u3a_box)) % ald_w;
@@ -467,7 +518,7 @@ _ca_willoc(c3_w len_w, c3_w ald_w, c3_w alp_w)
           /* Flush a bunch of cell cache, then try again.
           */
           if ( 0 == box_u ) {
-            if ( u3R->all.cel_p ) {
+            if ( c3y == _ca_reflux_any() ) {
               u3a_reflux();
 
               return _ca_willoc(len_w, ald_w, alp_w);
@@ -548,6 +599,141 @@ _ca_willoc(c3_w len_w, c3_w ald_w, c3_w alp_w)
   }
 }
 
+/* _ca_block(): carve [num_w] boxes of [siz_w] words from the hat,
+**              pushing them (in use, so never coalesced) onto [lis_p].
+*/
+static c3_o
+_ca_block(c3_w siz_w, c3_w num_w, u3p(u3a_fbox)* lis_p)
+{
+  u3p(u3a_fbox) fre_p;
+  c3_w          i_w;
+
+  if ( c3y == u3a_is_north(u3R) ) {
+    if ( u3R->cap_p <= (u3R->hat_p + (num_w * siz_w) + (1 << u3a_page)) ) {
+      return c3n;
+    }
+    else {
+      u3_post cel_p = *lis_p;
+      u3_post hat_p = u3R->hat_p;
+      u3R->hat_p   += (num_w * siz_w);
+
+      for ( i_w = 0; i_w < num_w; i_w++) {
+        u3_post  all_p = hat_p;
+        void*    box_v = u3a_into(all_p);
+        u3a_box* box_u = box_v;
+        c3_w*    box_w = box_v;
+
+        //  hand inline of _box_make(u3a_into(all_p), siz_w, 1)
+        {
+          box_w[0] = siz_w;
+          box_w[siz_w - 1] = siz_w;
+          box_u->use_w = 1;
+#ifdef U3_MEMORY_DEBUG
+            box_u->cod_w = 0;
+            box_u->eus_w = 0;
+#endif
+        }
+        hat_p += siz_w;
+
+        fre_p = u3of(u3a_fbox, box_u);
+        u3to(u3a_fbox, fre_p)->nex_p = cel_p;
+        cel_p = fre_p;
+      }
+
+      *lis_p = cel_p;
+    }
+  }
+  else {
+    if ( (u3R->cap_p + (num_w * siz_w) + (1 << u3a_page)) >= u3R->hat_p ) {
+      return c3n;
+    }
+    else {
+      u3_post cel_p = *lis_p;
+      u3_post hat_p = u3R->hat_p;
+      u3R->hat_p   -= (num_w * siz_w);
+
+      for ( i_w = 0; i_w < num_w; i_w++ ) {
+        u3_post  all_p = (hat_p -= siz_w);
+        void*    box_v = u3a_into(all_p);
+        u3a_box* box_u = box_v;
+        c3_w*    box_w = box_v;
+
+        //  hand inline of _box_make(u3a_into(all_p), siz_w, 1);
+        {
+          box_w[0] = siz_w;
+          box_w[siz_w - 1] = siz_w;
+          box_u->use_w = 1;
+# ifdef U3_MEMORY_DEBUG
+            box_u->cod_w = 0;
+            box_u->eus_w = 0;
+# endif
+        }
+        fre_p = u3of(u3a_fbox, box_u);
+        u3to(u3a_fbox, fre_p)->nex_p = cel_p;
+        cel_p = fre_p;
+      }
+
+      *lis_p = cel_p;
+    }
+  }
+  _box_count(num_w * siz_w);
+  return c3y;
+}
+
+/* _ca_slab_ok(): yes if boxes of [siz_w] words are slab-allocated.
+**
+**   like the cell allocator, slabs are only used on inner roads:
+**   cached boxes look allocated, and would be leaks on the home road.
+*/
+static inline c3_o
+_ca_slab_ok(c3_w siz_w)
+{
+#ifdef U3_MEMORY_DEBUG
+  if ( u3C.wag_w & u3o_debug_ram ) {
+    return c3n;
+  }
+#endif
+
+  return __(  (siz_w > u3a_minimum)
+           && (siz_w <= (u3a_minimum + u3a_slab_no))
+           && (u3R != &(u3H->rod_u)) );
+}
+
+/* _ca_slab_alloc(): allocate a box of [siz_w] words from its slab list.
+*/
+static void*
+_ca_slab_alloc(c3_w siz_w)
+{
+  u3p(u3a_fbox)* lis_p = &u3R->sab_p[siz_w - (u3a_minimum + 1)];
+  u3a_box*       box_u;
+
+  if ( !*lis_p && (c3n == _ca_block(siz_w, 512, lis_p)) ) {
+    return 0;
+  }
+
+  box_u  = &(u3to(u3a_fbox, *lis_p)->box_u);
+  *lis_p = u3to(u3a_fbox, *lis_p)->nex_p;
+
+  box_u->use_w = 1;
+  _box_count(-(c3_ws)siz_w);
+
+  return u3a_boxto(box_u);
+}
+
+/* _ca_slab_free(): return a box to its slab list.
+*/
+static void
+_ca_slab_free(u3a_box* box_u)
+{
+  u3p(u3a_fbox)* lis_p = &u3R->sab_p[box_u->siz_w - (u3a_minimum + 1)];
+  u3p(u3a_fbox)  fre_p = u3of(u3a_fbox, box_u);
+
+  _box_count(box_u->siz_w);
+
+  u3to(u3a_fbox, fre_p)->nex_p = *lis_p;
+  *lis_p = fre_p;
+}
+
 /* _ca_walloc(): u3a_walloc() internals.
 */
 static void*
@@ -570,9 +756,16 @@ _ca_walloc(c3_w len_w, c3_w ald_w, c3_w alp_w)
 void*
 u3a_walloc(c3_w len_w)
 {
-  void* ptr_v;
+  void* ptr_v = 0;
+  c3_w  siz_w = _box_align(u3a_boxed(len_w));
 
-  ptr_v = _ca_walloc(len_w, 1, 0);
+  if ( c3y == _ca_slab_ok(siz_w) ) {
+    ptr_v = _ca_slab_alloc(siz_w);
+  }
+
+  if ( !ptr_v ) {
+    ptr_v = _ca_walloc(len_w, 1, 0);
+  }
 
 #if 0
   if ( (703 == u3_Code) &&
@@ -640,7 +833,14 @@ u3a_pile_prep(u3a_pile* pil_u, c3_w len_w)
 void
 u3a_wfree(void* tox_v)
 {
-  _box_free(u3a_botox(tox_v));
+  u3a_box* box_u = u3a_botox(tox_v);
+
+  if ( (1 == box_u->use_w) && (c3y == _ca_slab_ok(box_u->siz_w)) ) {
+    _ca_slab_free(box_u);
+  }
+  else {
+    _box_free(box_u);
+  }
 }
 
 /* u3a_wtrim(): trim storage.
@@ -654,14 +854,16 @@ u3a_wtrim(void* tox_v, c3_w old_w, c3_w len_w)
      && ((old_w - len_w) >= u3a_minimum) )
   {
     c3_w* box_w = (void *)u3a_botox(nov_w);
-    c3_w* end_w = (nov_w + len_w + 1);
-    c3_w  asz_w = (end_w - box_w);
+    c3_w  asz_w = _box_align(u3a_boxed(len_w));
+    c3_w* end_w = (box_w + asz_w);
     c3_w  bsz_w = box_w[0] - asz_w;
 
-    _box_attach(_box_make(end_w, bsz_w, 0));
+    if ( bsz_w >= u3a_minimum ) {
+      _box_attach(_box_make(end_w, bsz_w, 0));
 
-    box_w[0] = asz_w;
-    box_w[asz_w - 1] = asz_w;
+      box_w[0] = asz_w;
+      box_w[asz_w - 1] = asz_w;
+    }
   }
 }
 
@@ -686,7 +888,14 @@ void*
 u3a_malloc(size_t len_i)
 {
   c3_w    len_w = (c3_w)((len_i + 3) >> 2);
+#if 0 == u3a_vits
   c3_w*   ptr_w = _ca_walloc(len_w + 1, 4, 3);
+#else
+  //  an aligned box could leave its neighbors unaligned;
+  //  instead, leave room to align within the box
+  //
+  c3_w*   ptr_w = _ca_walloc(len_w + 4, 1, 0);
+#endif
   u3_post ptr_p = u3a_outa(ptr_w);
   c3_w    pad_w = _me_align_pad(ptr_p, 4, 3);
   c3_w*   out_w = u3a_into(ptr_p + pad_w + 1);
@@ -710,79 +919,7 @@ u3a_malloc(size_t len_i)
 static c3_o
 u3a_cellblock(c3_w num_w)
 {
-  u3p(u3a_fbox) fre_p;
-  c3_w          i_w;
-
-  if ( c3y == u3a_is_north(u3R) ) {
-    if ( u3R->cap_p <= (u3R->hat_p + (num_w * u3a_minimum) + (1 << u3a_page)) ) {
-      return c3n;
-    }
-    else {
-      u3_post cel_p = u3R->all.cel_p;
-      u3_post hat_p = u3R->hat_p;
-      u3R->hat_p   += (num_w * u3a_minimum);
-
-      for ( i_w = 0; i_w < num_w; i_w++) {
-        u3_post  all_p = hat_p;
-        void*    box_v = u3a_into(all_p);
-        u3a_box* box_u = box_v;
-        c3_w*    box_w = box_v;
-
-        //  hand inline of _box_make(u3a_into(all_p), u3a_minimum, 1)
-        {
-          box_w[0] = u3a_minimum;
-          box_w[u3a_minimum - 1] = u3a_minimum;
-          box_u->use_w = 1;
-#ifdef U3_MEMORY_DEBUG
-            box_u->cod_w = 0;
-            box_u->eus_w = 0;
-#endif
-        }
-        hat_p += u3a_minimum;
-
-        fre_p = u3of(u3a_fbox, box_u);
-        u3to(u3a_fbox, fre_p)->nex_p = cel_p;
-        cel_p = fre_p;
-      }
-
-      u3R->all.cel_p = cel_p;
-    }
-  }
-  else {
-    if ( (u3R->cap_p + (num_w * u3a_minimum) + (1 << u3a_page)) >= u3R->hat_p ) {
-      return c3n;
-    }
-    else {
-      u3_post cel_p = u3R->all.cel_p;
-      u3_post hat_p = u3R->hat_p;
-      u3R->hat_p   -= (num_w * u3a_minimum);
-
-      for ( i_w = 0; i_w < num_w; i_w++ ) {
-        u3_post  all_p = (hat_p -= u3a_minimum);
-        void*    box_v = u3a_into(all_p);
-        u3a_box* box_u = box_v;
-        c3_w*    box_w = box_v;
-
-        //  hand inline of _box_make(u3a_into(all_p), u3a_minimum, 1);
-        {
-          box_w[0] = u3a_minimum;
-          box_w[u3a_minimum - 1] = u3a_minimum;
-          box_u->use_w = 1;
-# ifdef U3_MEMORY_DEBUG
-            box_u->cod_w = 0;
-            box_u->eus_w = 0;
-# endif
-        }
-        fre_p = u3of(u3a_fbox, box_u);
-        u3to(u3a_fbox, fre_p)->nex_p = cel_p;
-        cel_p = fre_p;
-      }
-
-      u3R->all.cel_p = cel_p;
-    }
-  }
-  _box_count(num_w * u3a_minimum);
-  return c3y;
+  return _ca_block(u3a_minimum, num_w, &u3R->all.cel_p);
 }
 
 /* u3a_celloc(): allocate a cell.
@@ -1475,6 +1612,118 @@ u3a_lose(u3_noun som)
   u3t_off(mal_o);
 }
 
+/* _ca_is_normal(): yes if [dog] is junior to the current road.
+*/
+static inline c3_o
+_ca_is_normal(u3_noun dog)
+{
+  return ( c3y == u3a_is_north(u3R) )
+         ? u3a_north_is_normal(u3R, dog)
+         : u3a_south_is_normal(u3R, dog);
+}
+
+/* u3a_shed(): lose a reference later, freeing via u3a_flush().
+**
+**   nouns that would be freed are queued on the road (as a list, so
+**   that they are marked, rewritten, and saved like any other root).
+*/
+void
+u3a_shed(u3_noun som)
+{
+  if (  !_(u3a_is_cat(som))
+     && (c3y == _ca_is_normal(som)) )
+  {
+    u3a_box* box_u = u3a_botox(u3a_to_ptr(som));
+
+    if ( box_u->use_w > 1 ) {
+      box_u->use_w -= 1;
+    }
+    else {
+      u3R->laz = u3nc(som, u3R->laz);
+    }
+  }
+}
+
+/* _ca_shed_some(): lose [dog], freeing at most [*bud_w] boxes,
+**                  and queueing whatever remains.
+*/
+static void
+_ca_shed_some(u3_noun dog, c3_w* bud_w)
+{
+  while (  !_(u3a_is_cat(dog))
+        && (c3y == _ca_is_normal(dog)) )
+  {
+    c3_w*    dog_w = u3a_to_ptr(dog);
+    u3a_box* box_u = u3a_botox(dog_w);
+
+    if ( box_u->use_w > 1 ) {
+      box_u->use_w -= 1;
+      return;
+    }
+    else if ( 0 == box_u->use_w ) {
+      u3m_bail(c3__foul);
+    }
+    else if ( !*bud_w ) {
+      u3R->laz = u3nc(dog, u3R->laz);
+      return;
+    }
+
+    *bud_w -= 1;
+
+    if ( _(u3a_is_pom(dog)) ) {
+      u3a_cell* dog_u = (void *)dog_w;
+      u3_noun     h_dog = dog_u->hed;
+      u3_noun     t_dog = dog_u->tel;
+
+      //  the head waits its turn, rather than recursing, in the dying
+      //  cell itself (as [h_dog laz]), so that draining never allocates
+      //
+      if ( !_(u3a_is_cat(h_dog)) ) {
+        dog_u->tel = u3R->laz;
+        u3R->laz   = dog;
+      }
+      else {
+        u3a_cfree(dog_w);
+      }
+      dog = t_dog;
+    }
+    else {
+      u3a_wfree(dog_w);
+      return;
+    }
+  }
+}
+
+/* u3a_flush(): free deferred nouns, at most [bud_w] boxes (0: all).
+*/
+c3_o
+u3a_flush(c3_w bud_w)
+{
+  c3_w max_w = ( bud_w ) ? bud_w : 0xffffffff;
+
+  u3t_on(mal_o);
+
+  while ( u3_nul != u3R->laz ) {
+    u3_noun laz = u3R->laz;
+    u3_noun dog = u3h(laz);
+
+    if ( !max_w ) {
+      u3t_off(mal_o);
+      return c3n;
+    }
+
+    //  the queue is never shared, so its cells are freed directly
+    //
+    u3R->laz = u3t(laz);
+    u3a_cfree(u3a_to_ptr(laz));
+
+    _ca_shed_some(dog, &max_w);
+  }
+
+  u3t_off(mal_o);
+  return c3y;
+}
+
 /* u3a_use(): reference count.
 */
 c3_w
@@ -1910,13 +2159,13 @@ u3a_print_memory(FILE* fil_u, c3_c* cap_c, c3_w wor_w)
 {
   c3_assert( 0 != fil_u );
 
-  c3_w byt_w = (wor_w * 4);
-  c3_w gib_w = (byt_w / 1000000000);
-  c3_w mib_w = (byt_w % 1000000000) / 1000000;
-  c3_w kib_w = (byt_w % 1000000) / 1000;
-  c3_w bib_w = (byt_w % 1000);
+  c3_d byt_d = ((c3_d)wor_w * 4);
+  c3_w gib_w = (byt_d / 1000000000);
+  c3_w mib_w = (byt_d % 1000000000) / 1000000;
+  c3_w kib_w = (byt_d % 1000000) / 1000;
+  c3_w bib_w = (byt_d % 1000);
 
-  if ( byt_w ) {
+  if ( byt_d ) {
     if ( gib_w ) {
       fprintf(fil_u, "%s: GB/%d.%03d.%03d.%03d\r\n",
           cap_c, gib_w, mib_w, kib_w, bib_w);
@@ -1957,6 +2206,7 @@ u3a_mark_road(FILE* fil_u)
   tot_w += u3a_maid(fil_u, "  profile doss", u3a_mark_noun(u3R->pro.day));
   tot_w += u3a_maid(fil_u, "  new profile trace", u3a_mark_noun(u3R->pro.trace));
   tot_w += u3a_maid(fil_u, "  memoization cache", u3h_mark(u3R->cax.har_p));
+  tot_w += u3a_maid(fil_u, "  deferred losses", u3a_mark_noun(u3R->laz));
   return   u3a_maid(fil_u, "total road stuff", tot_w);
 }
 
@@ -1969,6 +2219,10 @@ u3a_reclaim(void)
   //
   u3h_free(u3R->cax.har_p);
   u3R->cax.har_p = u3h_new();
+
+  //  finish any deferred losses
+  //
+  u3a_flush(0);
 }
 
 /* u3a_rewrite_compact(): rewrite pointers in ad-hoc persistent road structures.
@@ -1983,6 +2237,7 @@ u3a_rewrite_compact(void)
   u3a_rewrite_noun(u3R->pro.day);
   u3a_rewrite_noun(u3R->pro.trace);
   u3h_rewrite(u3R->cax.har_p);
+  u3a_rewrite_noun(u3R->laz);
 
   u3R->ski.gul = u3a_rewritten_noun(u3R->ski.gul);
   u3R->bug.tax = u3a_rewritten_noun(u3R->bug.tax);
@@ -1991,6 +2246,7 @@ u3a_rewrite_compact(void)
   u3R->pro.day = u3a_rewritten_noun(u3R->pro.day);
   u3R->pro.trace = u3a_rewritten_noun(u3R->pro.trace);
   u3R->cax.har_p = u3a_rewritten(u3R->cax.har_p);
+  u3R->laz = u3a_rewritten_noun(u3R->laz);
 }
 
 /* _ca_print_box(): heuristically print the contents of an allocation box.
@@ -2457,6 +2713,10 @@ u3a_pack_move(u3a_road* rod_u)
 
     u3R->all.fre_w = 0;
     u3R->all.cel_p = 0;
+
+    for ( i_w = 0; i_w < u3a_slab_no; i_w++ ) {
+      u3R->sab_p[i_w] = 0;
+    }
   }
 }
 
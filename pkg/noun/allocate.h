@@ -5,9 +5,17 @@
 
   /**  Constants.
   **/
+    /* u3a_vits: number of bits by which noun references are shifted.
+    */
+#     define u3a_vits  U3_OS_LoomShift
+
+    /* u3a_walign: alignment of loom allocations, in words.
+    */
+#     define u3a_walign  (1 << u3a_vits)
+
     /* u3a_bits: number of bits in word-addressed pointer.  29 == 2GB.
     */
-#     define u3a_bits  U3_OS_LoomBits
+#     define u3a_bits  (U3_OS_LoomBits + u3a_vits)
 
     /* u3a_page: number of bits in word-addressed page.  12 == 16Kbyte page.
     */
@@ -19,7 +27,7 @@
 
     /* u3a_words: maximum number of words in memory.
     */
-#     define u3a_words  (1 << u3a_bits)
+#     define u3a_words  ((c3_w)1 << u3a_bits)
 
     /* u3a_bytes: maximum number of bytes in memory.
     */
@@ -42,6 +50,11 @@
     */
 #     define u3a_fbox_no   27
 
+    /* u3a_slab_no: number of slab lists, for boxes of exactly
+    **              (u3a_minimum + 1) to (u3a_minimum + u3a_slab_no) words.
+    */
+#     define u3a_slab_no   8
+
 
   /**  Structures.
   **/
@@ -117,7 +130,9 @@
         u3p(c3_w) rut_p;                      //  bottom of durable region
         u3p(c3_w) ear_p;                      //  original cap if kid is live
 
-        c3_w fut_w[32];                       //  futureproof buffer
+        c3_w fut_w[31 - u3a_slab_no];         //  futureproof buffer
+        u3_noun laz;                          //  deferred losses (u3a_shed)
+        u3p(u3a_fbox) sab_p[u3a_slab_no];     //  slab lists (inner roads)
 
         struct {                              //  escape buffer
           union {
@@ -170,6 +185,7 @@
     */
       enum u3a_flag {
         u3a_flag_sand  = 0x1,                 //  bump allocation (XX not impl)
+        u3a_flag_lite  = 0x2,                 //  discard jet caches on love
       };
 
     /* u3a_pile: stack control, abstracted over road direction.
@@ -214,9 +230,9 @@
     */
 #     define u3a_is_pom(som)    ((0b11 == ((som) >> 30)) ? c3y : c3n)
 
-    /* u3a_to_off(): mask off bits 30 and 31 from noun [som].
+    /* u3a_to_off(): mask off bits 30 and 31 from noun [som], and unshift.
     */
-#     define u3a_to_off(som)    ((som) & 0x3fffffff)
+#     define u3a_to_off(som)    (((som) & 0x3fffffff) << u3a_vits)
 
     /* u3a_to_ptr(): convert noun [som] into generic pointer into loom.
     */
@@ -226,13 +242,13 @@
     */
 #     define u3a_to_wtr(som)    ((c3_w *)u3a_to_ptr(som))
 
-    /* u3a_to_pug(): set bit 31 of [off].
+    /* u3a_to_pug(): shift [off] and set bit 31.
     */
-#     define u3a_to_pug(off)    (off | 0x80000000)
+#     define u3a_to_pug(off)    (((off) >> u3a_vits) | 0x80000000)
 
-    /* u3a_to_pom(): set bits 30 and 31 of [off].
+    /* u3a_to_pom(): shift [off] and set bits 30 and 31.
     */
-#     define u3a_to_pom(off)    (off | 0xc0000000)
+#     define u3a_to_pom(off)    (((off) >> u3a_vits) | 0xc0000000)
 
     /* u3a_is_atom(): yes if noun [som] is direct atom or indirect atom.
     */
@@ -519,6 +535,17 @@
         */
           void
           u3a_lose(u3_weak som);
+
+        /* u3a_shed(): lose a reference later, freeing via u3a_flush().
+        */
+          void
+          u3a_shed(u3_noun som);
+
+        /* u3a_flush(): free deferred nouns, at most [bud_w] boxes (0: all).
+        **              yes if none remain.
+        */
+          c3_o
+          u3a_flush(c3_w bud_w);
 #         define u3z(som) u3a_lose(som)
 
         /* u3a_wash(): wash all lazy mugs in subtree.  RETAIN.
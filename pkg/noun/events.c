@@ -22,11 +22,21 @@
 //!   - if a patch is present, it's applied (crash recovery).
 //!   - snapshot segments are copied onto the loom; all included pages
 //!     are marked clean and protected (read-only).
+//!   - with u3o_page_out, north pages that stay clean through several
+//!     saves are remapped from north.bin at save time, in long runs, so
+//!     that their memory becomes reclaimable page cache.
+//!   - with u3o_lazy, the north segment is instead mapped copy-on-write
+//!     (MAP_PRIVATE) over the loom, so pages are read from disk on first
+//!     access and copied on first write (caught by the fault handler, as
+//!     usual). the south segment is reversed on disk and is always copied.
 //!
 //! #### page faults (u3e_fault())
 //!
 //!   - stores into protected pages generate faults (currently SIGSEGV,
 //!     handled outside this module).
+//!   - with u3o_soft (linux), pages are left writable and stores are
+//!     tracked by the kernel's soft-dirty bits instead; these are merged
+//!     into the same bitmap at save time, and reset after each patch.
 //!   - faults are handled by dirtying the page and switching protections to
 //!     read/write.
 //!   - a guard page is initially placed in the approximate middle of the free
@@ -46,15 +56,36 @@
 //!       high/low watermarks; the last page in each is always adjacent to the
 //!       contiguous free space).
 //!   - patch pages are written to memory.bin, metadata to control.bin.
-//!   - the patch is applied to the snapshot segments, in-place.
-//!   - patch files are deleted.
+//!     pages are stored as runs of changed words against the image page,
+//!     when that's less than half a page; unchanged pages are skipped.
+//!     runs hold new words, not differences, so reapplying a page after
+//!     an interrupted (even torn) write still produces the same page.
+//!   - on a background thread, the patch is synced and applied to the
+//!     snapshot segments, in-place, and the patch files are deleted.
+//!     the next save (or exit) waits for this to finish.
+//!
+//! ### page checksums (check.bin)
+//!
+//!   - the mug of every snapshot page is kept in memory, and persisted
+//!     in control-block format (u3e_control) alongside the segments.
+//!   - patches already carry the mugs of their pages, so applying a patch
+//!     updates the table without rehashing anything; the table is
+//!     rewritten after the segments are synced, and before the patch is
+//!     deleted, so a crash in between is repaired by reapplying the patch.
+//!   - at boot, the loaded segments are checked against the table in
+//!     parallel, and missing entries (from older piers) are filled in.
 //!
 //! ### limitations
 //!
-//!   - loom page size is fixed (16 KB), and must be a multiple of the
-//!     system page size. (can the size vary at runtime give south.bin's
+//!   - loom page size is fixed (16 KB) on disk, and must be a multiple of
+//!     the system page size. (can the size vary at runtime give south.bin's
 //!     reversed order? alternately, if system page size > ours, the fault
 //!     handler could dirty N pages at a time.)
+//!   - dirty tracking (faults, protections, the dirty bitmap, and the guard
+//!     page) can use larger granules of 64 KB (u3o_page_big) or 2 MB
+//!     (u3o_page_huge, which also advises transparent huge pages, renewed
+//!     after every remap of the loom); every page of a dirty granule is
+//!     saved, so the on-disk format is unchanged.
 //!   - update atomicity is suspect: patch application must either
 //!     completely succeed or leave on-disk segments intact. unapplied
 //!     patches can be discarded (triggering event replay), but once
@@ -65,18 +96,28 @@
 //!
 //! ### enhancements
 //!
-//!   - use platform specific page fault mechanism (mach rpc, userfaultfd, &c).
-//!   - implement demand paging / heuristic page-out.
+//!   - use platform specific page fault mechanism (mach rpc, &c).
+//!   - demand paging / page-out of the south segment.
+//!   - page-out by access (rather than store) recency.
 //!   - add a guard page in the middle of the loom to reactively handle stack overflow.
-//!   - parallelism
+//!   - parallelism in patch composition
 //!
 
 #include "events.h"
 
 #include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
 #include <sys/stat.h>
 
+#if defined(U3_OS_linux)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#elif defined(U3_OS_osx)
+#include <copyfile.h>
+#endif
+
 #include "log.h"
 #include "manage.h"
 #include "options.h"
@@ -89,12 +130,49 @@ u3e_pool u3e_Pool;
 // Base loom offset of the guard page.
 static u3p(c3_w) gar_pag_p;
 
+// Times the guard page has been recentered.
+static c3_w gar_cen_w;
+
+// Pages of north.bin mapped copy-on-write over the loom (u3o_lazy).
+static c3_w nor_map_w;
+
+// /proc/self/pagemap, when tracking soft-dirty bits (u3o_soft).
+static c3_i pam_i = -1;
+
+// Consecutive saves each north page has stayed clean (u3o_page_out).
+static c3_y age_y[u3a_pages];
+
+// North pages paged out to north.bin (u3o_page_out).
+static c3_w out_w[u3a_pages >> 5];
+
+//! Saves a page must stay clean for to be paged out.
+static const c3_y col_y = 4;
+
+//! Shortest run of cold pages worth remapping (bounds mapping count).
+static const c3_w col_run_w = 64;
+
+//! Most patch pages coalesced into one image write.
+static const c3_w app_run_w = 64;
+
+// Snapshot patch being committed in the background, if any.
+static u3_ce_patch* sav_pat_u;
+static pthread_t    sav_tid_u;
+
 //! Urbit page size in 4-byte words.
 static const size_t pag_wiz_i = 1 << u3a_page;
 
 //! Urbit page size in bytes.
 static const size_t pag_siz_i = sizeof(c3_w) * pag_wiz_i;
 
+//! Dirty-tracking granule, in log2 pages (u3o_page_big, u3o_page_huge).
+static c3_y gra_y;
+
+//! Dirty-tracking granule size in 4-byte words.
+static size_t gra_wiz_i = 1 << u3a_page;
+
+//! Dirty-tracking granule size in bytes.
+static size_t gra_siz_i = sizeof(c3_w) << u3a_page;
+
 #ifdef U3_SNAPSHOT_VALIDATION
 /* Image check.
 */
@@ -196,6 +274,26 @@ _ce_mapfree(void* map_v)
 }
 #endif
 
+/* _ce_loom_huge(): ask for transparent huge pages on a loom range.
+**
+**   only in 2MB mode (u3o_page_huge), where faults and protections are
+**   whole huge pages; smaller granules would split them again. advice
+**   is per-mapping, so it must be renewed after any MAP_FIXED remap.
+*/
+static void
+_ce_loom_huge(c3_w* ptr_w, size_t len_i)
+{
+#ifdef MADV_HUGEPAGE
+  if (  (7 == gra_y)
+     && len_i
+     && madvise((void*)ptr_w, len_i, MADV_HUGEPAGE) )
+  {
+    fprintf(stderr, "loom: huge pages unavailable: %s\r\n",
+                    strerror(errno));
+  }
+#endif
+}
+
 #ifdef U3_GUARD_PAGE
 //! Place a guard page at the (approximate) middle of the free space between
 //! the heap and stack of the current road, bailing if memory has been
@@ -209,22 +307,22 @@ _ce_center_guard_page(void)
     bot_p = u3a_outa(u3_Loom);
   }
   else if ( c3y == u3a_is_north(u3R) ) {
-    top_p = c3_rod(u3R->cap_p, pag_wiz_i);
-    bot_p = c3_rop(u3R->hat_p, pag_wiz_i);
+    top_p = c3_rod(u3R->cap_p, gra_wiz_i);
+    bot_p = c3_rop(u3R->hat_p, gra_wiz_i);
   }
   else {
-    top_p = c3_rod(u3R->hat_p, pag_wiz_i);
-    bot_p = c3_rop(u3R->cap_p, pag_wiz_i);
+    top_p = c3_rod(u3R->hat_p, gra_wiz_i);
+    bot_p = c3_rop(u3R->cap_p, gra_wiz_i);
   }
 
-  if ( top_p < bot_p + pag_wiz_i ) {
+  if ( top_p < bot_p + gra_wiz_i ) {
     fprintf(stderr,
             "loom: not enough memory to recenter the guard page\r\n");
     goto bail;
   }
   const u3p(c3_w) old_gar_p = gar_pag_p;
   const c3_w      mid_p     = (top_p - bot_p) / 2;
-  gar_pag_p                 = bot_p + c3_rod(mid_p, pag_wiz_i);
+  gar_pag_p                 = bot_p + c3_rod(mid_p, gra_wiz_i);
   if ( old_gar_p == gar_pag_p ) {
     fprintf(stderr,
             "loom: can't move the guard page to the same location"
@@ -233,7 +331,7 @@ _ce_center_guard_page(void)
     goto bail;
   }
 
-  if ( -1 == mprotect(u3a_into(gar_pag_p), pag_siz_i, PROT_NONE) ) {
+  if ( -1 == mprotect(u3a_into(gar_pag_p), gra_siz_i, PROT_NONE) ) {
     fprintf(stderr,
             "loom: failed to protect the guard page "
             "(base address %p): %s\r\n",
@@ -242,6 +340,7 @@ _ce_center_guard_page(void)
     goto fail;
   }
 
+  gar_cen_w++;
   return 1;
 
 bail:
@@ -251,6 +350,199 @@ fail:
 }
 #endif /* ifdef U3_GUARD_PAGE */
 
+/* _ce_dirty_test(): test the dirty bit of [pag_w]'s granule.
+*/
+static inline c3_o
+_ce_dirty_test(c3_w pag_w)
+{
+  c3_w gan_w = pag_w >> gra_y;
+
+  return __(u3P.dit_w[gan_w >> 5] & (1 << (gan_w & 31)));
+}
+
+/* _ce_dirty_mark(): set the dirty bit of [pag_w]'s granule.
+*/
+static inline void
+_ce_dirty_mark(c3_w pag_w)
+{
+  c3_w gan_w = pag_w >> gra_y;
+
+  u3P.dit_w[gan_w >> 5] |= (1 << (gan_w & 31));
+}
+
+/* _ce_loom_clean(): mark the granules spanning [pgs_w] pages from [pag_w]
+**                   clean, and protect them.
+*/
+static void
+_ce_loom_clean(c3_w pag_w, c3_w pgs_w)
+{
+  c3_w gan_w = pag_w >> gra_y;
+  c3_w end_w = (pag_w + pgs_w + ((1 << gra_y) - 1)) >> gra_y;
+
+  for ( ; gan_w < end_w; gan_w++ ) {
+    c3_w blk_w = (gan_w >> 5);
+    c3_w bit_w = (gan_w & 31);
+
+    if ( !(u3P.dit_w[blk_w] & (1 << bit_w)) ) {
+      continue;
+    }
+
+    if (  (-1 == pam_i)
+       && (-1 == mprotect(u3_Loom + ((size_t)gan_w << (gra_y + u3a_page)),
+                          gra_siz_i,
+                          PROT_READ)) )
+    {
+      fprintf(stderr, "loom: clean mprotect: %s\r\n", strerror(errno));
+      c3_assert(0);
+    }
+
+    u3P.dit_w[blk_w] &= ~(1 << bit_w);
+  }
+}
+
+#if defined(U3_OS_linux)
+//! Soft-dirty flag in a pagemap entry (see linux/Documentation/admin-guide/mm).
+static const c3_d pam_dit_d = (c3_d)1 << 55;
+
+/* _ce_soft_clear(): reset soft-dirty bits for the whole process.
+*/
+static c3_o
+_ce_soft_clear(void)
+{
+  c3_i fid_i = c3_open("/proc/self/clear_refs", O_WRONLY);
+
+  if ( -1 == fid_i ) {
+    fprintf(stderr, "loom: soft-dirty open: %s\r\n", strerror(errno));
+    return c3n;
+  }
+  else if ( 1 != write(fid_i, "4", 1) ) {
+    fprintf(stderr, "loom: soft-dirty clear: %s\r\n", strerror(errno));
+    close(fid_i);
+    return c3n;
+  }
+
+  close(fid_i);
+  return c3y;
+}
+
+/* _ce_soft_test(): read the soft-dirty bit for an address.
+*/
+static c3_o
+_ce_soft_test(void* adr_v)
+{
+  size_t sys_i = sysconf(_SC_PAGESIZE);
+  c3_d   ent_d;
+  off_t  off_i = (off_t)(((c3_ps)adr_v / sys_i) * sizeof(ent_d));
+
+  if ( sizeof(ent_d) != pread(pam_i, &ent_d, sizeof(ent_d), off_i) ) {
+    return c3n;
+  }
+
+  return __(ent_d & pam_dit_d);
+}
+
+/* _ce_soft_init(): enable soft-dirty tracking, if the kernel supports it.
+*/
+static void
+_ce_soft_init(void)
+{
+  c3_y* tes_y;
+  c3_o  suc_o;
+
+  if ( -1 == (pam_i = c3_open("/proc/self/pagemap", O_RDONLY)) ) {
+    fprintf(stderr, "loom: soft-dirty pagemap: %s\r\n", strerror(errno));
+    return;
+  }
+
+  //  probe a scratch page: kernels built without CONFIG_MEM_SOFT_DIRTY
+  //  accept the clear, but never report a page as dirty.
+  //
+  tes_y = mmap(0, pag_siz_i, (PROT_READ | PROT_WRITE),
+               (MAP_ANON | MAP_PRIVATE), -1, 0);
+
+  if ( MAP_FAILED == tes_y ) {
+    suc_o = c3n;
+  }
+  else {
+    tes_y[0] = 1;
+    suc_o = _ce_soft_clear();
+
+    if ( _(suc_o) ) {
+      suc_o = __(c3n == _ce_soft_test(tes_y));
+    }
+    if ( _(suc_o) ) {
+      tes_y[0] = 2;
+      suc_o = _ce_soft_test(tes_y);
+    }
+
+    munmap(tes_y, pag_siz_i);
+  }
+
+  if ( c3n == suc_o ) {
+    fprintf(stderr, "loom: soft-dirty unsupported, using mprotect\r\n");
+    close(pam_i);
+    pam_i = -1;
+  }
+}
+
+/* _ce_soft_sync(): merge soft-dirty bits into the dirty-page bitmap.
+*/
+static void
+_ce_soft_sync(void)
+{
+  size_t sys_i = sysconf(_SC_PAGESIZE);
+  c3_w   per_w = pag_siz_i / sys_i;
+  c3_w   pgs_w = c3_max(1, 1024 / per_w);
+  c3_d   ent_d[1024];
+  c3_w   pag_w, i_w, j_w;
+
+  for ( pag_w = 0; pag_w < u3P.pag_w; pag_w += pgs_w ) {
+    c3_w    len_w = c3_min(pgs_w, u3P.pag_w - pag_w);
+    size_t  siz_i = (size_t)len_w * per_w * sizeof(c3_d);
+    c3_ps   adr_p = (c3_ps)(u3_Loom + ((size_t)pag_w << u3a_page));
+    off_t   off_i = (off_t)((adr_p / sys_i) * sizeof(c3_d));
+    ssize_t ret_i;
+
+    if ( siz_i != (ret_i = pread(pam_i, ent_d, siz_i, off_i)) ) {
+      //  can't tell, so assume the worst
+      //
+      fprintf(stderr, "loom: soft-dirty read: %s\r\n",
+                      ( 0 > ret_i ) ? strerror(errno) : "short");
+      for ( i_w = 0; i_w < len_w; i_w++ ) {
+        _ce_dirty_mark(pag_w + i_w);
+      }
+      continue;
+    }
+
+    for ( i_w = 0; i_w < len_w; i_w++ ) {
+      for ( j_w = 0; j_w < per_w; j_w++ ) {
+        if ( ent_d[(i_w * per_w) + j_w] & pam_dit_d ) {
+          _ce_dirty_mark(pag_w + i_w);
+          break;
+        }
+      }
+    }
+  }
+}
+#else
+static c3_o
+_ce_soft_clear(void)
+{
+  return c3n;
+}
+
+static void
+_ce_soft_sync(void)
+{
+}
+
+static void
+_ce_soft_init(void)
+{
+  fprintf(stderr, "loom: soft-dirty unsupported, using mprotect\r\n");
+}
+#endif /* if defined(U3_OS_linux) */
+
 /* u3e_fault(): handle a memory event with libsigsegv protocol.
 */
 c3_i
@@ -275,12 +567,13 @@ u3e_fault(void* adr_v, c3_i ser_i)
 
   u3p(c3_w) adr_p  = u3a_outa(adr_w);
   c3_w      pag_w  = adr_p >> u3a_page;
-  c3_w      blk_w  = (pag_w >> 5);
-  c3_w      bit_w  = (pag_w & 31);
+  c3_w      gan_w  = pag_w >> gra_y;
+  c3_w      blk_w  = (gan_w >> 5);
+  c3_w      bit_w  = (gan_w & 31);
 
 #ifdef U3_GUARD_PAGE
   // The fault happened in the guard page.
-  if ( gar_pag_p <= adr_p && adr_p < gar_pag_p + pag_wiz_i ) {
+  if ( gar_pag_p <= adr_p && adr_p < gar_pag_p + gra_wiz_i ) {
     if ( 0 == _ce_center_guard_page() ) {
       return 0;
     }
@@ -295,8 +588,8 @@ u3e_fault(void* adr_v, c3_i ser_i)
 
   u3P.dit_w[blk_w] |= (1 << bit_w);
 
-  if ( -1 == mprotect((void *)(u3_Loom + (pag_w << u3a_page)),
-                      pag_siz_i,
+  if ( -1 == mprotect((void *)(u3_Loom + ((size_t)gan_w << (gra_y + u3a_page))),
+                      gra_siz_i,
                       (PROT_READ | PROT_WRITE)) )
   {
     fprintf(stderr, "loom: fault mprotect: %s\r\n", strerror(errno));
@@ -455,13 +748,189 @@ _ce_patch_delete(void)
   }
 }
 
+/* _ce_delta_etch(): encode the runs of page [new_w] that differ from
+**                   [old_w] into [dat_w], producing c3n if it isn't
+**                   worth it.
+**
+**   the encoding is a sequence of [skip:1 run:1 new:run] words.
+*/
+static c3_o
+_ce_delta_etch(const c3_w* new_w,
+               const c3_w* old_w,
+               c3_w*       dat_w,
+               c3_w*       len_w)
+{
+  c3_w max_w = pag_wiz_i >> 1;
+  c3_w pos_w = 0;
+  c3_w i_w   = 0;
+
+  while ( i_w < pag_wiz_i ) {
+    c3_w skp_w = 0;
+    c3_w run_w = 0;
+
+    while ( (i_w < pag_wiz_i) && (new_w[i_w] == old_w[i_w]) ) {
+      skp_w++;
+      i_w++;
+    }
+
+    if ( i_w == pag_wiz_i ) {
+      break;
+    }
+
+    while (  ((i_w + run_w) < pag_wiz_i)
+          && (new_w[i_w + run_w] != old_w[i_w + run_w]) )
+    {
+      run_w++;
+    }
+
+    if ( (pos_w + 2 + run_w) > max_w ) {
+      return c3n;
+    }
+
+    dat_w[pos_w++] = skp_w;
+    dat_w[pos_w++] = run_w;
+
+    while ( run_w-- ) {
+      dat_w[pos_w++] = new_w[i_w];
+      i_w++;
+    }
+  }
+
+  *len_w = pos_w;
+  return c3y;
+}
+
+/* _ce_delta_sift(): overwrite [mem_w] with the [len_w]-word delta [dat_w].
+*/
+static c3_o
+_ce_delta_sift(c3_w len_w, const c3_w* dat_w, c3_w* mem_w)
+{
+  c3_w pos_w = 0;
+  c3_w i_w   = 0;
+
+  while ( i_w < len_w ) {
+    c3_w skp_w, run_w;
+
+    if ( (len_w - i_w) < 2 ) {
+      return c3n;
+    }
+
+    skp_w = dat_w[i_w++];
+    run_w = dat_w[i_w++];
+
+    if (  (skp_w > (pag_wiz_i - pos_w))
+       || (run_w > (pag_wiz_i - pos_w - skp_w))
+       || (run_w > (len_w - i_w)) )
+    {
+      return c3n;
+    }
+
+    pos_w += skp_w;
+
+    while ( run_w-- ) {
+      mem_w[pos_w++] = dat_w[i_w++];
+    }
+  }
+
+  return c3y;
+}
+
+/* _ce_patch_locate(): find a patch page in the images.
+*/
+static void
+_ce_patch_locate(u3_ce_patch* pat_u,
+                 c3_w         pag_w,
+                 c3_i*        fid_i,
+                 off_t*       off_i)
+{
+  if ( pag_w < pat_u->con_u->nor_w ) {
+    *fid_i = u3P.nor_u.fid_i;
+    *off_i = (off_t)pag_w << (u3a_page + 2);
+  }
+  else {
+    *fid_i = u3P.sou_u.fid_i;
+    *off_i = (off_t)(u3P.pag_w - (pag_w + 1)) << (u3a_page + 2);
+  }
+}
+
+/* _ce_patch_page(): reconstruct patch page [i_w], stored at [off_i].
+**
+**   deltas apply to the page in the image, which may already have been
+**   (partly) patched by an interrupted application; as they only hold
+**   new words, the result is the same either way.
+*/
+static c3_o
+_ce_patch_page(u3_ce_patch* pat_u,
+               c3_w         i_w,
+               off_t        off_i,
+               c3_w*        mem_w)
+{
+  u3e_line* lin_u = &pat_u->con_u->mem_u[i_w];
+  c3_w      dat_w[pag_wiz_i];
+  ssize_t   ret_i;
+
+  if (  (lin_u->siz_w > pag_siz_i)
+     || (lin_u->siz_w & 3)
+     || (!lin_u->del_w && (pag_siz_i != lin_u->siz_w)) )
+  {
+    fprintf(stderr, "loom: patch page %d: bad size %u\r\n",
+                    lin_u->pag_w, lin_u->siz_w);
+    return c3n;
+  }
+
+  if ( lin_u->siz_w != (ret_i = pread(pat_u->mem_i,
+                                      ( lin_u->del_w ) ? dat_w : mem_w,
+                                      lin_u->siz_w,
+                                      off_i)) )
+  {
+    if ( 0 < ret_i ) {
+      fprintf(stderr, "loom: patch partial read: %zu\r\n", (size_t)ret_i);
+    }
+    else {
+      fprintf(stderr, "loom: patch read fail: %s\r\n", strerror(errno));
+    }
+    return c3n;
+  }
+
+  if ( lin_u->del_w ) {
+    c3_i  fid_i;
+    off_t pos_i;
+
+    _ce_patch_locate(pat_u, lin_u->pag_w, &fid_i, &pos_i);
+
+    if ( pag_siz_i != (ret_i = pread(fid_i, mem_w, pag_siz_i, pos_i)) ) {
+      fprintf(stderr, "loom: patch page %d: base read: %s\r\n",
+                      lin_u->pag_w,
+                      ( 0 > ret_i ) ? strerror(errno) : "short");
+      return c3n;
+    }
+
+    if ( c3n == _ce_delta_sift(lin_u->siz_w >> 2, dat_w, mem_w) ) {
+      fprintf(stderr, "loom: patch page %d: bad delta\r\n", lin_u->pag_w);
+      return c3n;
+    }
+  }
+
+  {
+    c3_w nug_w = u3r_mug_words(mem_w, pag_wiz_i);
+
+    if ( lin_u->mug_w != nug_w ) {
+      fprintf(stderr, "loom: patch mug mismatch %d/%d; (%x, %x)\r\n",
+                      lin_u->pag_w, i_w, lin_u->mug_w, nug_w);
+      return c3n;
+    }
+  }
+
+  return c3y;
+}
+
 /* _ce_patch_verify(): check patch data mug.
 */
 static c3_o
 _ce_patch_verify(u3_ce_patch* pat_u)
 {
-  ssize_t ret_i;
-  c3_w      i_w;
+  off_t off_i = 0;
+  c3_w  i_w;
 
   if ( u3e_version != pat_u->con_u->ver_y ) {
     fprintf(stderr, "loom: patch version mismatch: have %u, need %u\r\n",
@@ -470,38 +939,21 @@ _ce_patch_verify(u3_ce_patch* pat_u)
     return c3n;
   }
 
+  if ( u3a_vits != pat_u->con_u->vit_w ) {
+    fprintf(stderr, "loom: patch layout mismatch: have %u, need %u\r\n",
+                    pat_u->con_u->vit_w,
+                    u3a_vits);
+    return c3n;
+  }
+
   for ( i_w = 0; i_w < pat_u->con_u->pgs_w; i_w++ ) {
-    c3_w pag_w = pat_u->con_u->mem_u[i_w].pag_w;
-    c3_w mug_w = pat_u->con_u->mem_u[i_w].mug_w;
-    c3_w mem_w[1 << u3a_page];
+    c3_w mem_w[pag_wiz_i];
 
-    if ( -1 == lseek(pat_u->mem_i, (i_w << (u3a_page + 2)), SEEK_SET) ) {
-      fprintf(stderr, "loom: patch seek: %s\r\n", strerror(errno));
-      return c3n;
-    }
-    if ( pag_siz_i != (ret_i = read(pat_u->mem_i, mem_w, pag_siz_i)) ) {
-      if ( 0 < ret_i ) {
-        fprintf(stderr, "loom: patch partial read: %zu\r\n", (size_t)ret_i);
-      }
-      else {
-        fprintf(stderr, "loom: patch read fail: %s\r\n", strerror(errno));
-      }
+    if ( c3n == _ce_patch_page(pat_u, i_w, off_i, mem_w) ) {
       return c3n;
     }
-    {
-      c3_w nug_w = u3r_mug_words(mem_w, pag_wiz_i);
 
-      if ( mug_w != nug_w ) {
-        fprintf(stderr, "loom: patch mug mismatch %d/%d; (%x, %x)\r\n",
-                        pag_w, i_w, mug_w, nug_w);
-        return c3n;
-      }
-#if 0
-      else {
-        u3l_log("verify: patch %d/%d, %x", pag_w, i_w, mug_w);
-      }
-#endif
-    }
+    off_i += pat_u->con_u->mem_u[i_w].siz_w;
   }
   return c3y;
 }
@@ -565,21 +1017,17 @@ _ce_patch_open(void)
   return pat_u;
 }
 
-/* _ce_patch_write_page(): write a page of patch memory.
+/* _ce_patch_write_page(): write a page (or delta) of patch memory.
 */
 static void
 _ce_patch_write_page(u3_ce_patch* pat_u,
-                     c3_w         pgc_w,
-                     c3_w*        mem_w)
+                     off_t        off_i,
+                     c3_w*        mem_w,
+                     c3_w         siz_w)
 {
   ssize_t ret_i;
 
-  if ( -1 == lseek(pat_u->mem_i, pgc_w * pag_siz_i, SEEK_SET) ) {
-    fprintf(stderr, "loom: patch page seek: %s\r\n", strerror(errno));
-    c3_assert(0);
-  }
-
-  if ( pag_siz_i != (ret_i = write(pat_u->mem_i, mem_w, pag_siz_i)) ) {
+  if ( siz_w != (ret_i = pwrite(pat_u->mem_i, mem_w, siz_w, off_i)) ) {
     if ( 0 < ret_i ) {
       fprintf(stderr, "loom: patch page partial write: %zu\r\n",
                       (size_t)ret_i);
@@ -591,77 +1039,195 @@ _ce_patch_write_page(u3_ce_patch* pat_u,
   }
 }
 
+/* _ce_image_base(): read the current image page for [pag_w], if any.
+*/
+static c3_o
+_ce_image_base(c3_w pag_w, c3_o nor_o, c3_w* mem_w)
+{
+  u3e_image* img_u = ( c3y == nor_o ) ? &u3P.nor_u : &u3P.sou_u;
+  c3_w       off_w = ( c3y == nor_o ) ? pag_w : (u3P.pag_w - (pag_w + 1));
+
+  if ( off_w >= img_u->pgs_w ) {
+    return c3n;
+  }
+
+  return __(pag_siz_i == pread(img_u->fid_i, mem_w, pag_siz_i,
+                               (off_t)off_w << (u3a_page + 2)));
+}
+
 /* _ce_patch_count_page(): count a page, producing new counter.
 */
 static c3_w
 _ce_patch_count_page(c3_w pag_w,
                      c3_w pgc_w)
 {
-  c3_w blk_w = (pag_w >> 5);
-  c3_w bit_w = (pag_w & 31);
-
-  if ( u3P.dit_w[blk_w] & (1 << bit_w) ) {
+  if ( c3y == _ce_dirty_test(pag_w) ) {
     pgc_w += 1;
   }
   return pgc_w;
 }
 
 /* _ce_patch_save_page(): save a page, producing new page counter.
+**
+**   pages are stored as deltas against the image where that is smaller,
+**   and skipped entirely if unchanged. the page is left dirty, as its
+**   granule may hold other pages yet to be saved; see _ce_loom_clean().
 */
 static c3_w
 _ce_patch_save_page(u3_ce_patch* pat_u,
                     c3_w         pag_w,
-                    c3_w         pgc_w)
+                    c3_o         nor_o,
+                    c3_w         pgc_w,
+                    off_t*       off_i)
 {
-  c3_w blk_w = (pag_w >> 5);
-  c3_w bit_w = (pag_w & 31);
-
-  if ( u3P.dit_w[blk_w] & (1 << bit_w) ) {
-    c3_w* mem_w = u3_Loom + (pag_w << u3a_page);
-
-    pat_u->con_u->mem_u[pgc_w].pag_w = pag_w;
-    pat_u->con_u->mem_u[pgc_w].mug_w = u3r_mug_words(mem_w, pag_wiz_i);
-
-#if 0
-    u3l_log("protect a: page %d", pag_w);
-#endif
-    _ce_patch_write_page(pat_u, pgc_w, mem_w);
+  if ( c3y == _ce_dirty_test(pag_w) ) {
+    u3e_line* lin_u = &pat_u->con_u->mem_u[pgc_w];
+    c3_w*     mem_w = u3_Loom + (pag_w << u3a_page);
+    c3_w*     out_w = mem_w;
+    c3_w      siz_w = pag_siz_i;
+    c3_w      del_w = 0;
+    c3_w      mug_w = u3r_mug_words(mem_w, pag_wiz_i);
+    c3_w      old_w[pag_wiz_i];
+    c3_w      dat_w[pag_wiz_i >> 1];
+    c3_w      len_w;
+
+    if ( c3y == _ce_image_base(pag_w, nor_o, old_w) ) {
+      if ( 0 == memcmp(old_w, mem_w, pag_siz_i) ) {
+        return pgc_w;
+      }
 
-    if ( -1 == mprotect(u3_Loom + (pag_w << u3a_page),
-                        pag_siz_i,
-                        PROT_READ) )
-    {
-      fprintf(stderr, "loom: patch mprotect: %s\r\n", strerror(errno));
-      c3_assert(0);
+      if ( c3y == _ce_delta_etch(mem_w, old_w, dat_w, &len_w) ) {
+        out_w = dat_w;
+        siz_w = len_w << 2;
+        del_w = 1;
+      }
     }
 
-    u3P.dit_w[blk_w] &= ~(1 << bit_w);
-    pgc_w += 1;
+    lin_u->pag_w = pag_w;
+    lin_u->mug_w = mug_w;
+    lin_u->del_w = del_w;
+    lin_u->siz_w = siz_w;
+
+    _ce_patch_write_page(pat_u, *off_i, out_w, siz_w);
+    *off_i += siz_w;
+    pgc_w  += 1;
   }
   return pgc_w;
 }
 
-/* _ce_patch_compose(): make and write current patch.
+/* _ce_cold_age(): age the north pages, forgetting any touched.
 */
-static u3_ce_patch*
-_ce_patch_compose(void)
+static void
+_ce_cold_age(c3_w nor_w)
 {
-  c3_w pgs_w = 0;
-  c3_w nor_w = 0;
-  c3_w sou_w = 0;
-
-  /* Calculate number of saved pages, north and south.
-  */
-  {
-    c3_w nwr_w, swu_w;
+  c3_w pag_w;
+
+  for ( pag_w = 0; pag_w < nor_w; pag_w++ ) {
+    if ( c3y == _ce_dirty_test(pag_w) ) {
+      age_y[pag_w] = 0;
+      out_w[pag_w >> 5] &= ~(1 << (pag_w & 31));
+    }
+    else if ( age_y[pag_w] < 0xff ) {
+      age_y[pag_w]++;
+    }
+  }
+}
+
+/* _ce_cold_page_out(): remap long-clean runs of north pages from the
+**                      image, so that they're reclaimable page cache.
+**
+**   only pages that stayed clean through a previous save are eligible,
+**   as pages saved by the current patch are not yet in the image.
+**   the south segment is reversed on disk, and so is never paged out.
+*/
+static void
+_ce_cold_page_out(c3_w nor_w)
+{
+  c3_w max_w = c3_min(nor_w, u3P.nor_u.pgs_w);
+  c3_w pag_w = 0;
+  c3_w tot_w = 0;
+
+  while ( pag_w < max_w ) {
+    c3_w fir_w;
+
+    while (  (pag_w < max_w)
+          && (  (age_y[pag_w] < col_y)
+             || (out_w[pag_w >> 5] & (1 << (pag_w & 31)))) )
+    {
+      pag_w++;
+    }
+
+    fir_w = pag_w;
+
+    while (  (pag_w < max_w)
+          && (age_y[pag_w] >= col_y)
+          && !(out_w[pag_w >> 5] & (1 << (pag_w & 31))) )
+    {
+      pag_w++;
+    }
+
+    if ( (pag_w - fir_w) < col_run_w ) {
+      continue;
+    }
+
+    if ( MAP_FAILED == mmap((void*)(u3_Loom + ((size_t)fir_w << u3a_page)),
+                            (size_t)(pag_w - fir_w) << (u3a_page + 2),
+                            ( -1 == pam_i ) ? PROT_READ
+                                            : (PROT_READ | PROT_WRITE),
+                            (MAP_FIXED | MAP_PRIVATE),
+                            u3P.nor_u.fid_i,
+                            (off_t)fir_w << (u3a_page + 2)) )
+    {
+      //  the old mapping may be gone, so this is not recoverable
+      //
+      fprintf(stderr, "loom: page-out mmap: %s\r\n", strerror(errno));
+      c3_assert(0);
+    }
+
+    _ce_loom_huge(u3_Loom + ((size_t)fir_w << u3a_page),
+                  (size_t)(pag_w - fir_w) << (u3a_page + 2));
+
+    {
+      c3_w i_w;
+
+      for ( i_w = fir_w; i_w < pag_w; i_w++ ) {
+        out_w[i_w >> 5] |= (1 << (i_w & 31));
+      }
+    }
+
+    nor_map_w = c3_max(nor_map_w, pag_w);
+    tot_w    += pag_w - fir_w;
+  }
+
+  if ( tot_w && (u3C.wag_w & u3o_verbose) ) {
+    u3l_log("loom: paged out %u pages", tot_w);
+  }
+}
+
+/* _ce_patch_compose(): make and write current patch.
+*/
+static u3_ce_patch*
+_ce_patch_compose(void)
+{
+  c3_w pgs_w = 0;
+  c3_w nor_w = 0;
+  c3_w sou_w = 0;
+
+  /* Calculate number of saved pages, north and south.
+  */
+  {
+    c3_w nwr_w, swu_w;
 
     u3m_water(&nwr_w, &swu_w);
 
     nor_w = (nwr_w + (pag_wiz_i - 1)) >> u3a_page;
     sou_w = (swu_w + (pag_wiz_i - 1)) >> u3a_page;
 
-    c3_assert(  ((gar_pag_p >> u3a_page) >= nor_w)
-             && ((gar_pag_p >> u3a_page) <= (u3a_pages - (sou_w + 1))) );
+    //  the guard granule must not share a granule with saved pages
+    //
+    c3_assert(  ((gar_pag_p >> u3a_page) >= c3_rop(nor_w, 1 << gra_y))
+             && (((gar_pag_p >> u3a_page) + (1 << gra_y))
+                 <= c3_rod(u3P.pag_w - sou_w, 1 << gra_y)) );
   }
 
 #ifdef U3_SNAPSHOT_VALIDATION
@@ -669,6 +1235,16 @@ _ce_patch_compose(void)
   u3K.sou_w = sou_w;
 #endif
 
+  //  collect stores tracked by the kernel
+  //
+  if ( -1 != pam_i ) {
+    _ce_soft_sync();
+  }
+
+  if ( u3C.wag_w & u3o_page_out ) {
+    _ce_cold_age(nor_w);
+  }
+
   /* Count dirty pages.
   */
   {
@@ -687,24 +1263,43 @@ _ce_patch_compose(void)
   }
   else {
     u3_ce_patch* pat_u = c3_malloc(sizeof(u3_ce_patch));
+    off_t        off_i = 0;
     c3_w i_w, pgc_w;
 
     _ce_patch_create(pat_u);
     pat_u->con_u = c3_malloc(sizeof(u3e_control) + (pgs_w * sizeof(u3e_line)));
     pat_u->con_u->ver_y = u3e_version;
+    pat_u->con_u->vit_w = u3a_vits;
     pgc_w = 0;
 
     for ( i_w = 0; i_w < nor_w; i_w++ ) {
-      pgc_w = _ce_patch_save_page(pat_u, i_w, pgc_w);
+      pgc_w = _ce_patch_save_page(pat_u, i_w, c3y, pgc_w, &off_i);
     }
     for ( i_w = 0; i_w < sou_w; i_w++ ) {
-      pgc_w = _ce_patch_save_page(pat_u, (u3P.pag_w - (i_w + 1)), pgc_w);
+      pgc_w = _ce_patch_save_page(pat_u, (u3P.pag_w - (i_w + 1)),
+                                  c3n, pgc_w, &off_i);
     }
 
     pat_u->con_u->nor_w = nor_w;
     pat_u->con_u->sou_w = sou_w;
     pat_u->con_u->pgs_w = pgc_w;
 
+    //  saved pages are now clean; protect them, or restart kernel tracking
+    //
+    _ce_loom_clean(0, nor_w);
+    _ce_loom_clean(u3P.pag_w - sou_w, sou_w);
+
+    //  release cold memory; remapping counts as a store for soft-dirty
+    //  tracking, so this must precede the reset below
+    //
+    if ( u3C.wag_w & u3o_page_out ) {
+      _ce_cold_page_out(nor_w);
+    }
+
+    if ( (-1 != pam_i) && (c3n == _ce_soft_clear()) ) {
+      c3_assert(!"loom: soft-dirty clear failed");
+    }
+
     _ce_patch_write_control(pat_u);
     return pat_u;
   }
@@ -747,7 +1342,7 @@ static void
 _ce_image_resize(u3e_image* img_u, c3_w pgs_w)
 {
   if ( img_u->pgs_w > pgs_w ) {
-    if ( ftruncate(img_u->fid_i, pgs_w << (u3a_page + 2)) ) {
+    if ( ftruncate(img_u->fid_i, (off_t)pgs_w << (u3a_page + 2)) ) {
       fprintf(stderr, "loom: image (%s) truncate: %s\r\n",
                       img_u->nam_c,
                       strerror(errno));
@@ -758,75 +1353,392 @@ _ce_image_resize(u3e_image* img_u, c3_w pgs_w)
   img_u->pgs_w = pgs_w;
 }
 
-/* _ce_patch_apply(): apply patch to images.
+/* _ce_check_trim(): forget page mugs outside of the image segments.
 */
 static void
-_ce_patch_apply(u3_ce_patch* pat_u)
+_ce_check_trim(void)
 {
-  ssize_t ret_i;
-  c3_w      i_w;
+  c3_w nor_w = u3P.nor_u.pgs_w;
+  c3_w sou_w = u3P.sou_u.pgs_w;
 
-  //  resize images
-  //
-  _ce_image_resize(&u3P.nor_u, pat_u->con_u->nor_w);
-  _ce_image_resize(&u3P.sou_u, pat_u->con_u->sou_w);
+  if ( (nor_w + sou_w) < u3P.pag_w ) {
+    memset(u3P.mug_w + nor_w, 0,
+           sizeof(c3_w) * (u3P.pag_w - (nor_w + sou_w)));
+  }
+}
+
+/* _ce_check_read(): load page mugs from [dir_c]/check.bin into [mug_w].
+**
+**   south pages are indexed from the top of the loom, so a table
+**   written with a different loom size is rejected (it would lack
+**   the topmost page).
+*/
+static c3_o
+_ce_check_read(c3_c* dir_c, c3_w* mug_w)
+{
+  u3e_control* con_u;
+  struct stat  buf_u;
+  c3_c         ful_c[8193];
+  c3_i         fid_i;
+  c3_w         len_w, i_w;
+  c3_o         top_o, ret_o = c3n;
+
+  snprintf(ful_c, 8192, "%s/check.bin", dir_c);
+
+  if ( -1 == (fid_i = c3_open(ful_c, O_RDONLY)) ) {
+    return c3n;
+  }
+
+  if ( -1 == fstat(fid_i, &buf_u) ) {
+    fprintf(stderr, "loom: check stat: %s\r\n", strerror(errno));
+    close(fid_i);
+    return c3n;
+  }
+
+  len_w = (c3_w)buf_u.st_size;
+  con_u = c3_malloc(len_w);
 
-  //  seek to begining of patch and images
+  if (  (len_w < sizeof(u3e_control))
+     || (len_w != read(fid_i, con_u, len_w))
+     || (u3e_version != con_u->ver_y)
+     || (u3a_vits != con_u->vit_w)
+     || (len_w != sizeof(u3e_control) + (con_u->pgs_w * sizeof(u3e_line))) )
+  {
+    fprintf(stderr, "loom: %s invalid, ignoring\r\n", ful_c);
+  }
+  else {
+    top_o = __(!con_u->sou_w);
+
+    for ( i_w = 0; i_w < con_u->pgs_w; i_w++ ) {
+      if ( (u3P.pag_w - 1) == con_u->mem_u[i_w].pag_w ) {
+        top_o = c3y;
+      }
+    }
+
+    if ( c3y == top_o ) {
+      for ( i_w = 0; i_w < con_u->pgs_w; i_w++ ) {
+        c3_w pag_w = con_u->mem_u[i_w].pag_w;
+
+        if ( pag_w < u3P.pag_w ) {
+          mug_w[pag_w] = con_u->mem_u[i_w].mug_w;
+        }
+      }
+
+      ret_o = c3y;
+    }
+  }
+
+  c3_free(con_u);
+  close(fid_i);
+  return ret_o;
+}
+
+/* _ce_check_write(): persist known page mugs to [dir_c]/check.bin.
+*/
+static c3_o
+_ce_check_write(c3_c* dir_c)
+{
+  c3_w         nor_w = u3P.nor_u.pgs_w;
+  c3_w         sou_w = u3P.sou_u.pgs_w;
+  c3_w         pgs_w = 0;
+  u3e_control* con_u;
+  c3_c         ful_c[8193];
+  c3_c         tmp_c[8193];
+  c3_i         fid_i;
+  c3_w         len_w, i_w;
+
+  con_u = c3_malloc(sizeof(u3e_control)
+                    + ((nor_w + sou_w) * sizeof(u3e_line)));
+  con_u->ver_y = u3e_version;
+  con_u->vit_w = u3a_vits;
+  con_u->nor_w = nor_w;
+  con_u->sou_w = sou_w;
+
+  for ( i_w = 0; i_w < (nor_w + sou_w); i_w++ ) {
+    c3_w pag_w = ( i_w < nor_w ) ? i_w : (u3P.pag_w - (i_w - nor_w) - 1);
+
+    if ( u3P.mug_w[pag_w] ) {
+      con_u->mem_u[pgs_w].pag_w = pag_w;
+      con_u->mem_u[pgs_w].mug_w = u3P.mug_w[pag_w];
+      con_u->mem_u[pgs_w].del_w = 0;
+      con_u->mem_u[pgs_w].siz_w = 0;
+      pgs_w++;
+    }
+  }
+
+  con_u->pgs_w = pgs_w;
+  len_w = sizeof(u3e_control) + (pgs_w * sizeof(u3e_line));
+
+  snprintf(ful_c, 8192, "%s/check.bin", dir_c);
+  snprintf(tmp_c, 8192, "%s/check.bin.tmp", dir_c);
+
+  //  write-and-rename, so that a torn table is never read back;
+  //  on failure, remove the old table, as it no longer matches
   //
-  if (  (-1 == lseek(pat_u->mem_i, 0, SEEK_SET))
-     || (-1 == lseek(u3P.nor_u.fid_i, 0, SEEK_SET))
-     || (-1 == lseek(u3P.sou_u.fid_i, 0, SEEK_SET)) )
+  if (  (-1 == (fid_i = c3_open(tmp_c, O_RDWR | O_CREAT | O_TRUNC, 0600)))
+     || (len_w != write(fid_i, con_u, len_w))
+     || (-1 == c3_sync(fid_i))
+     || (-1 == close(fid_i))
+     || c3_rename(tmp_c, ful_c) )
   {
-    fprintf(stderr, "loom: patch apply seek 0: %s\r\n", strerror(errno));
-    c3_assert(0);
+    fprintf(stderr, "loom: check write %s: %s\r\n", ful_c, strerror(errno));
+    c3_unlink(tmp_c);
+    c3_unlink(ful_c);
+    c3_free(con_u);
+    return c3n;
   }
 
-  //  write patch pages into the appropriate image
+  c3_free(con_u);
+  return c3y;
+}
+
+/* _ce_check_span: page mug verification, per thread.
+*/
+typedef struct _ce_check_span {
+  pthread_t tid_u;                      //  thread
+  c3_w      fir_w;                      //  first image page index
+  c3_w      las_w;                      //  last image page index (exclusive)
+  c3_w      bad_w;                      //  pages mismatched
+  c3_w      new_w;                      //  pages newly hashed
+} _ce_check_span;
+
+/* _ce_check_span_cb(): verify (or fill in) mugs of loaded image pages.
+*/
+static void*
+_ce_check_span_cb(void* spa_v)
+{
+  _ce_check_span* spa_u = spa_v;
+  c3_w            nor_w = u3P.nor_u.pgs_w;
+  c3_w            i_w;
+
+  for ( i_w = spa_u->fir_w; i_w < spa_u->las_w; i_w++ ) {
+    c3_w pag_w = ( i_w < nor_w ) ? i_w : (u3P.pag_w - (i_w - nor_w) - 1);
+    c3_w mug_w = u3r_mug_words(u3_Loom + (pag_w << u3a_page), pag_wiz_i);
+
+    if ( !u3P.mug_w[pag_w] ) {
+      u3P.mug_w[pag_w] = mug_w;
+      spa_u->new_w++;
+    }
+    else if ( mug_w != u3P.mug_w[pag_w] ) {
+      if ( spa_u->bad_w < 8 ) {
+        fprintf(stderr, "loom: page %u corrupt: mug %x, expected %x\r\n",
+                        pag_w, mug_w, u3P.mug_w[pag_w]);
+      }
+      spa_u->bad_w++;
+    }
+  }
+
+  return 0;
+}
+
+/* _ce_check_image(): check loaded images against page mugs, in parallel.
+*/
+static c3_w
+_ce_check_image(void)
+{
+  c3_w            pgs_w = u3P.nor_u.pgs_w + u3P.sou_u.pgs_w;
+  c3_w            thr_w = c3_max(1, c3_min(16, sysconf(_SC_NPROCESSORS_ONLN)));
+  c3_w            bad_w = 0;
+  c3_w            new_w = 0;
+  _ce_check_span* spa_u;
+  c3_w            i_w;
+
+  thr_w = c3_max(1, c3_min(thr_w, pgs_w >> 6));
+  spa_u = c3_calloc(thr_w * sizeof(*spa_u));
+
+  for ( i_w = 0; i_w < thr_w; i_w++ ) {
+    spa_u[i_w].fir_w = (c3_w)(((c3_d)pgs_w * i_w) / thr_w);
+    spa_u[i_w].las_w = (c3_w)(((c3_d)pgs_w * (i_w + 1)) / thr_w);
+  }
+
+  //  the calling thread takes the first span
   //
-  for ( i_w = 0; i_w < pat_u->con_u->pgs_w; i_w++ ) {
-    c3_w pag_w = pat_u->con_u->mem_u[i_w].pag_w;
-    c3_w mem_w[pag_wiz_i];
-    c3_i fid_i;
-    c3_w off_w;
+  for ( i_w = 1; i_w < thr_w; i_w++ ) {
+    if ( pthread_create(&spa_u[i_w].tid_u, 0,
+                        _ce_check_span_cb, &spa_u[i_w]) )
+    {
+      _ce_check_span_cb(&spa_u[i_w]);
+      spa_u[i_w].tid_u = 0;
+    }
+  }
+
+  _ce_check_span_cb(&spa_u[0]);
 
-    if ( pag_w < pat_u->con_u->nor_w ) {
-      fid_i = u3P.nor_u.fid_i;
-      off_w = pag_w;
+  for ( i_w = 0; i_w < thr_w; i_w++ ) {
+    if ( i_w && spa_u[i_w].tid_u ) {
+      pthread_join(spa_u[i_w].tid_u, 0);
     }
-    else {
-      fid_i = u3P.sou_u.fid_i;
-      off_w = (u3P.pag_w - (pag_w + 1));
+    bad_w += spa_u[i_w].bad_w;
+    new_w += spa_u[i_w].new_w;
+  }
+
+  c3_free(spa_u);
+
+  if ( new_w && !bad_w && !(u3C.wag_w & u3o_dryrun) ) {
+    c3_c dir_c[8193];
+    snprintf(dir_c, 8192, "%s/.urb/chk", u3P.dir_c);
+    _ce_check_write(dir_c);
+  }
+
+  return bad_w;
+}
+
+/* _ce_image_shed(): unmap north.bin pages past a shrinking segment.
+*/
+static void
+_ce_image_shed(c3_w nor_w)
+{
+  if ( nor_w >= nor_map_w ) {
+    return;
+  }
+
+  //  these pages are above the north watermark (free space), and would
+  //  fault with SIGBUS once the image is truncated beneath them.
+  //  replace them with fresh anonymous memory, dirty and writable,
+  //  just as u3m_init() left them (along with the rest of their granules).
+  //
+  c3_w fir_w = nor_w >> gra_y;
+  c3_w end_w = (nor_map_w + ((1 << gra_y) - 1)) >> gra_y;
+
+  {
+    c3_w*  ptr_w = u3_Loom + ((size_t)nor_w << u3a_page);
+    size_t len_i = (size_t)(nor_map_w - nor_w) << (u3a_page + 2);
+    c3_w   gan_w, pag_w;
+
+    if ( MAP_FAILED == mmap((void*)ptr_w,
+                            len_i,
+                            (PROT_READ | PROT_WRITE),
+                            (MAP_ANON | MAP_FIXED | MAP_PRIVATE),
+                            -1, 0) )
+    {
+      fprintf(stderr, "loom: image shed mmap: %s\r\n", strerror(errno));
+      c3_assert(0);
     }
 
-    if ( pag_siz_i != (ret_i = read(pat_u->mem_i, mem_w, pag_siz_i)) ) {
-      if ( 0 < ret_i ) {
-        fprintf(stderr, "loom: patch apply partial read: %zu\r\n",
-                        (size_t)ret_i);
-      }
-      else {
-        fprintf(stderr, "loom: patch apply read: %s\r\n", strerror(errno));
-      }
+    _ce_loom_huge(ptr_w, len_i);
+
+    if (  gra_y
+       && (-1 == mprotect(u3_Loom + ((size_t)fir_w << (gra_y + u3a_page)),
+                          (size_t)(end_w - fir_w) * gra_siz_i,
+                          (PROT_READ | PROT_WRITE))) )
+    {
+      fprintf(stderr, "loom: image shed mprotect: %s\r\n", strerror(errno));
       c3_assert(0);
     }
-    else {
-      if ( -1 == lseek(fid_i, (off_w << (u3a_page + 2)), SEEK_SET) ) {
-        fprintf(stderr, "loom: patch apply seek: %s\r\n", strerror(errno));
-        c3_assert(0);
+
+    for ( gan_w = fir_w; gan_w < end_w; gan_w++ ) {
+      u3P.dit_w[gan_w >> 5] |= (1 << (gan_w & 31));
+    }
+
+    for ( pag_w = nor_w; pag_w < nor_map_w; pag_w++ ) {
+      out_w[pag_w >> 5] &= ~(1 << (pag_w & 31));
+      age_y[pag_w] = 0;
+    }
+  }
+
+#ifdef U3_GUARD_PAGE
+  {
+    c3_w gar_w = gar_pag_p >> (u3a_page + gra_y);
+
+    if (  (gar_w >= fir_w)
+       && (gar_w < end_w)
+       && (-1 == mprotect(u3a_into(gar_pag_p), gra_siz_i, PROT_NONE)) )
+    {
+      fprintf(stderr, "loom: failed to protect guard page: %s\r\n",
+                      strerror(errno));
+      c3_assert(0);
+    }
+  }
+#endif /* ifdef U3_GUARD_PAGE */
+
+  nor_map_w = nor_w;
+}
+
+/* _ce_patch_flush(): write [pgs_w] adjacent pages to [fid_i] at [pos_i].
+*/
+static void
+_ce_patch_flush(c3_i fid_i, off_t pos_i, c3_w pgs_w, c3_w* buf_w)
+{
+  size_t len_i = (size_t)pgs_w << (u3a_page + 2);
+  c3_y*  buf_y = (c3_y*)buf_w;
+  ssize_t ret_i;
+
+  while ( len_i ) {
+    if ( 0 >= (ret_i = pwrite(fid_i, buf_y, len_i, pos_i)) ) {
+      fprintf(stderr, "loom: patch apply write: %s\r\n",
+                      ( 0 > ret_i ) ? strerror(errno) : "short");
+      c3_assert(0);
+    }
+
+    buf_y += ret_i;
+    pos_i += ret_i;
+    len_i -= ret_i;
+  }
+}
+
+/* _ce_patch_apply(): apply patch to images.
+*/
+static void
+_ce_patch_apply(u3_ce_patch* pat_u)
+{
+  off_t off_i = 0;
+  c3_w    i_w;
+
+  //  resize images
+  //
+  _ce_image_resize(&u3P.nor_u, pat_u->con_u->nor_w);
+  _ce_image_resize(&u3P.sou_u, pat_u->con_u->sou_w);
+  _ce_check_trim();
+
+  //  write patch pages into the appropriate image. pages are saved in
+  //  image order, so runs of adjacent pages are written with one call.
+  //  (deltas are applied over each page's own position, which is never
+  //  part of a pending run.)
+  //
+  {
+    c3_w* buf_w = c3_malloc((size_t)app_run_w << (u3a_page + 2));
+    c3_w  run_w = 0;
+    c3_i  rid_i = -1;
+    off_t rup_i = 0;
+
+    for ( i_w = 0; i_w < pat_u->con_u->pgs_w; i_w++ ) {
+      c3_w  pag_w = pat_u->con_u->mem_u[i_w].pag_w;
+      c3_i  fid_i;
+      off_t pos_i;
+
+      _ce_patch_locate(pat_u, pag_w, &fid_i, &pos_i);
+
+      if (  run_w
+         && (  (app_run_w == run_w)
+            || (rid_i != fid_i)
+            || ((rup_i + ((off_t)run_w << (u3a_page + 2))) != pos_i) ) )
+      {
+        _ce_patch_flush(rid_i, rup_i, run_w, buf_w);
+        run_w = 0;
       }
-      if ( pag_siz_i != (ret_i = write(fid_i, mem_w, pag_siz_i)) ) {
-        if ( 0 < ret_i ) {
-          fprintf(stderr, "loom: patch apply partial write: %zu\r\n",
-                          (size_t)ret_i);
-        }
-        else {
-          fprintf(stderr, "loom: patch apply write: %s\r\n", strerror(errno));
-        }
+
+      if ( !run_w ) {
+        rid_i = fid_i;
+        rup_i = pos_i;
+      }
+
+      if ( c3n == _ce_patch_page(pat_u, i_w, off_i,
+                                 buf_w + ((size_t)run_w << u3a_page)) )
+      {
+        fprintf(stderr, "loom: patch apply failed\r\n");
         c3_assert(0);
       }
+
+      off_i += pat_u->con_u->mem_u[i_w].siz_w;
+      u3P.mug_w[pag_w] = pat_u->con_u->mem_u[i_w].mug_w;
+      run_w++;
     }
-#if 0
-    u3l_log("apply: %d, %x", pag_w, u3r_mug_words(mem_w, pag_wiz_i));
-#endif
+
+    if ( run_w ) {
+      _ce_patch_flush(rid_i, rup_i, run_w, buf_w);
+    }
+
+    c3_free(buf_w);
   }
 }
 
@@ -844,6 +1756,7 @@ _ce_image_blit(u3e_image* img_u,
   ssize_t ret_i;
   c3_w      i_w;
   c3_w    siz_w = pag_siz_i;
+  c3_w    fir_w = u3a_outa(ptr_w) >> u3a_page;
 
   if ( -1 == lseek(img_u->fid_i, 0, SEEK_SET) ) {
     fprintf(stderr, "loom: image (%s) blit seek 0: %s\r\n",
@@ -864,18 +1777,46 @@ _ce_image_blit(u3e_image* img_u,
       c3_assert(0);
     }
 
-    if ( 0 != mprotect(ptr_w, siz_w, PROT_READ) ) {
-      fprintf(stderr, "loom: live mprotect: %s\r\n", strerror(errno));
-      c3_assert(0);
-    }
+    fir_w  = c3_min(fir_w, u3a_outa(ptr_w) >> u3a_page);
+    ptr_w += stp_ws;
+  }
 
-    c3_w pag_w = u3a_outa(ptr_w) >> u3a_page;
-    c3_w blk_w = pag_w >> 5;
-    c3_w bit_w = pag_w & 31;
-    u3P.dit_w[blk_w] &= ~(1 << bit_w);
+  _ce_loom_clean(fir_w, img_u->pgs_w);
+}
 
-    ptr_w += stp_ws;
+/* _ce_image_mmap(): map north image over memory, copy-on-write.
+*/
+static void
+_ce_image_mmap(u3e_image* img_u)
+{
+  if ( 0 == img_u->pgs_w ) {
+    return;
+  }
+
+  //  only touched pages are read from disk; stores are caught by
+  //  u3e_fault() and copied into private memory by the kernel.
+  //  untouched pages stay shared with the page cache, which is safe
+  //  as patches only ever write dirty (already copied) pages.
+  //
+
+  size_t len_i = (size_t)img_u->pgs_w << (u3a_page + 2);
+
+  if ( MAP_FAILED == mmap((void*)u3_Loom,
+                          len_i,
+                          ( -1 == pam_i ) ? PROT_READ
+                                          : (PROT_READ | PROT_WRITE),
+                          (MAP_FIXED | MAP_PRIVATE),
+                          img_u->fid_i, 0) )
+  {
+    fprintf(stderr, "loom: image (%s) mmap: %s\r\n",
+                    img_u->nam_c, strerror(errno));
+    c3_assert(0);
   }
+
+  _ce_loom_huge(u3_Loom, len_i);
+  _ce_loom_clean(0, img_u->pgs_w);
+
+  nor_map_w = img_u->pgs_w;
 }
 
 #ifdef U3_SNAPSHOT_VALIDATION
@@ -929,36 +1870,91 @@ _ce_image_fine(u3e_image* img_u,
 }
 #endif
 
-/* _ce_image_copy():
+/* _ce_image_clone(): copy an image within the kernel, if possible.
 */
 static c3_o
-_ce_image_copy(u3e_image* fom_u, u3e_image* tou_u)
+_ce_image_clone(u3e_image* fom_u, u3e_image* tou_u)
 {
-  ssize_t ret_i;
-  c3_w      i_w;
-
-  //  resize images
+#if defined(U3_OS_linux)
+  size_t len_i = (size_t)fom_u->pgs_w << (u3a_page + 2);
+  loff_t fom_i = 0;
+  loff_t tou_i = 0;
+
+#  if defined(FICLONE)
+  //  share extents outright (btrfs, xfs, &c); a whole-file clone
+  //  doesn't shrink the destination, so truncate it to match
   //
-  _ce_image_resize(tou_u, fom_u->pgs_w);
+  if ( !ioctl(tou_u->fid_i, FICLONE, fom_u->fid_i) ) {
+    return __(!ftruncate(tou_u->fid_i, len_i));
+  }
+#  endif
 
-  //  seek to begining of patch and images
+  if ( ftruncate(tou_u->fid_i, len_i) ) {
+    return c3n;
+  }
+
+  //  copy without a round-trip through userspace;
+  //  some filesystems reflink or copy server-side
   //
+  while ( len_i ) {
+    ssize_t ret_i = copy_file_range(fom_u->fid_i, &fom_i,
+                                    tou_u->fid_i, &tou_i,
+                                    len_i, 0);
+    if ( 0 >= ret_i ) {
+      return c3n;
+    }
+
+    len_i -= ret_i;
+  }
+
+  return c3y;
+#elif defined(U3_OS_osx)
   if (  (-1 == lseek(fom_u->fid_i, 0, SEEK_SET))
-     || (-1 == lseek(tou_u->fid_i, 0, SEEK_SET)) )
+     || (-1 == lseek(tou_u->fid_i, 0, SEEK_SET))
+     || ftruncate(tou_u->fid_i, 0)
+     || fcopyfile(fom_u->fid_i, tou_u->fid_i, NULL, COPYFILE_DATA) )
   {
-    fprintf(stderr, "loom: image (%s) copy seek: %s\r\n",
-                    fom_u->nam_c,
-                    strerror(errno));
+    return c3n;
+  }
+
+  return c3y;
+#else
+  return c3n;
+#endif
+}
+
+/* _ce_image_copy(): copy an image page-by-page, skipping pages whose
+**                   mugs in [bak_w] (the destination's, if any) match.
+*/
+static c3_o
+_ce_image_copy(u3e_image* fom_u, u3e_image* tou_u, c3_w* bak_w)
+{
+  c3_o    nor_o = ( &u3P.nor_u == fom_u ) ? c3y : c3n;
+  ssize_t ret_i;
+  c3_w      i_w;
+  c3_w    pgs_w = 0;
+
+  if ( ftruncate(tou_u->fid_i, (off_t)fom_u->pgs_w << (u3a_page + 2)) ) {
+    fprintf(stderr, "loom: image (%s) copy truncate: %s\r\n",
+                    tou_u->nam_c, strerror(errno));
     return c3n;
   }
 
   //  copy pages into destination image
   //
   for ( i_w = 0; i_w < fom_u->pgs_w; i_w++ ) {
-    c3_w mem_w[pag_wiz_i];
-    c3_w off_w = i_w;
+    c3_w  pag_w = ( c3y == nor_o ) ? i_w : (u3P.pag_w - i_w - 1);
+    off_t off_i = (off_t)i_w << (u3a_page + 2);
+    c3_w  mem_w[pag_wiz_i];
+
+    if (  bak_w
+       && u3P.mug_w[pag_w]
+       && (bak_w[pag_w] == u3P.mug_w[pag_w]) )
+    {
+      continue;
+    }
 
-    if ( pag_siz_i != (ret_i = read(fom_u->fid_i, mem_w, pag_siz_i)) ) {
+    if ( pag_siz_i != (ret_i = pread(fom_u->fid_i, mem_w, pag_siz_i, off_i)) ) {
       if ( 0 < ret_i ) {
         fprintf(stderr, "loom: image (%s) copy partial read: %zu\r\n",
                         fom_u->nam_c, (size_t)ret_i);
@@ -969,38 +1965,41 @@ _ce_image_copy(u3e_image* fom_u, u3e_image* tou_u)
       }
       return c3n;
     }
-    else {
-      if ( -1 == lseek(tou_u->fid_i, (off_w << (u3a_page + 2)), SEEK_SET) ) {
-        fprintf(stderr, "loom: image (%s) copy seek: %s\r\n",
-                        tou_u->nam_c, strerror(errno));
-        return c3n;
+
+    if ( pag_siz_i != (ret_i = pwrite(tou_u->fid_i, mem_w, pag_siz_i, off_i)) ) {
+      if ( 0 < ret_i ) {
+        fprintf(stderr, "loom: image (%s) copy partial write: %zu\r\n",
+                        tou_u->nam_c, (size_t)ret_i);
       }
-      if ( pag_siz_i != (ret_i = write(tou_u->fid_i, mem_w, pag_siz_i)) ) {
-        if ( 0 < ret_i ) {
-          fprintf(stderr, "loom: image (%s) copy partial write: %zu\r\n",
-                          tou_u->nam_c, (size_t)ret_i);
-        }
-        else {
-          fprintf(stderr, "loom: image (%s) copy write: %s\r\n",
-                          tou_u->nam_c, strerror(errno));
-        }
-        return c3n;
+      else {
+        fprintf(stderr, "loom: image (%s) copy write: %s\r\n",
+                        tou_u->nam_c, strerror(errno));
       }
+      return c3n;
     }
+
+    pgs_w++;
+  }
+
+  if ( bak_w && (u3C.wag_w & u3o_verbose) ) {
+    u3l_log("loom: image (%s) backup: %u of %u pages changed",
+            fom_u->nam_c, pgs_w, fom_u->pgs_w);
   }
 
   return c3y;
 }
 
-/* u3e_backup();
+/* _ce_image_backup(): copy the snapshot from chk to bhk.
 */
-c3_o
-u3e_backup(c3_o ovw_o)
+static c3_o
+_ce_image_backup(c3_o ovw_o)
 {
   u3e_image nop_u = { .nam_c = "north", .pgs_w = 0 };
   u3e_image sop_u = { .nam_c = "south", .pgs_w = 0 };
   c3_i mod_i = O_RDWR | O_CREAT;
   c3_c ful_c[8193];
+  c3_w* bak_w;
+  c3_o  cop_o;
 
   snprintf(ful_c, 8192, "%s/.urb/bhk", u3P.dir_c);
 
@@ -1025,10 +2024,37 @@ u3e_backup(c3_o ovw_o)
     return c3n;
   }
 
-  if (  (c3n == _ce_image_copy(&u3P.nor_u, &nop_u))
-     || (c3n == _ce_image_copy(&u3P.sou_u, &sop_u)) )
+  //  load the previous backup's page mugs, then remove them,
+  //  so that a torn backup is never taken as up-to-date
+  //
   {
+    c3_c dir_c[8193];
+    c3_c chk_c[8193];
+
+    snprintf(dir_c, 8192, "%s/.urb/bhk", u3P.dir_c);
+    snprintf(chk_c, 8192, "%s/check.bin", dir_c);
+
+    bak_w = c3_calloc(sizeof(c3_w) * u3P.pag_w);
+
+    if ( c3n == _ce_check_read(dir_c, bak_w) ) {
+      c3_free(bak_w);
+      bak_w = 0;
+    }
+
+    c3_unlink(chk_c);
+  }
+
+  //  prefer copying within the kernel; failing that,
+  //  only rewrite pages that differ from the previous backup
+  //
+  cop_o = c3a(c3o(_ce_image_clone(&u3P.nor_u, &nop_u),
+                  _ce_image_copy(&u3P.nor_u, &nop_u, bak_w)),
+              c3o(_ce_image_clone(&u3P.sou_u, &sop_u),
+                  _ce_image_copy(&u3P.sou_u, &sop_u, bak_w)));
+
+  c3_free(bak_w);
 
+  if ( c3n == cop_o ) {
     c3_unlink(ful_c);
     snprintf(ful_c, 8192, "%s/.urb/bhk/%s.bin", u3P.dir_c, nop_u.nam_c);
     c3_unlink(ful_c);
@@ -1040,29 +2066,126 @@ u3e_backup(c3_o ovw_o)
 
   close(nop_u.fid_i);
   close(sop_u.fid_i);
+
+  snprintf(ful_c, 8192, "%s/.urb/bhk", u3P.dir_c);
+  _ce_check_write(ful_c);
+
   fprintf(stderr, "loom: image backup complete\r\n");
   return c3y;
 }
 
+/* u3e_backup(): copy the snapshot from chk to bhk.
+*/
+c3_o
+u3e_backup(c3_o ovw_o)
+{
+  u3e_wait();
+  return _ce_image_backup(ovw_o);
+}
+
+/* _ce_patch_commit(): sync, verify, and apply a patch to the images.
+*/
+static void
+_ce_patch_commit(u3_ce_patch* pat_u)
+{
+  _ce_patch_sync(pat_u);
+
+  if ( c3n == _ce_patch_verify(pat_u) ) {
+    c3_assert(!"loom: save failed");
+  }
+
+  _ce_patch_apply(pat_u);
+
+#ifdef U3_SNAPSHOT_VALIDATION
+  {
+    _ce_image_fine(&u3P.nor_u,
+                   u3_Loom,
+                   pag_wiz_i);
+
+    _ce_image_fine(&u3P.sou_u,
+                   (u3_Loom + u3C.wor_i) - pag_wiz_i,
+                   -(ssize_t)pag_wiz_i);
+
+    c3_assert(u3P.nor_u.pgs_w == u3K.nor_w);
+    c3_assert(u3P.sou_u.pgs_w == u3K.sou_w);
+  }
+#endif
+
+  _ce_image_sync(&u3P.nor_u);
+  _ce_image_sync(&u3P.sou_u);
+
+  {
+    c3_c dir_c[8193];
+    snprintf(dir_c, 8192, "%s/.urb/chk", u3P.dir_c);
+    _ce_check_write(dir_c);
+  }
+
+  _ce_patch_free(pat_u);
+  _ce_patch_delete();
+
+  _ce_image_backup(c3n);
+}
+
+/* _ce_patch_commit_cb(): background patch commit.
+*/
+static void*
+_ce_patch_commit_cb(void* pat_v)
+{
+  _ce_patch_commit(pat_v);
+  return 0;
+}
+
+/* u3e_wait(): wait for any background snapshot commit to finish.
+*/
+void
+u3e_wait(void)
+{
+  if ( sav_pat_u ) {
+    c3_i ret_i;
+
+    if ( 0 != (ret_i = pthread_join(sav_tid_u, 0)) ) {
+      fprintf(stderr, "loom: save join: %s\r\n", strerror(ret_i));
+      c3_assert(0);
+    }
+
+    sav_pat_u = 0;
+  }
+}
+
+/* _ce_wait_atexit(): finish the snapshot on the way out.
+*/
+static void
+_ce_wait_atexit(void)
+{
+  u3e_wait();
+}
+
 /*
   u3e_save(): save current changes.
 
   If we are in dry-run mode, do nothing.
 
-  First, call `_ce_patch_compose` to write all dirty pages to disk and
+  First, wait for the previous snapshot to be committed; its patch files
+  are still in use until then.
+
+  Then, call `_ce_patch_compose` to write all dirty pages to disk and
   clear protection and dirty bits. If there were no dirty pages to write,
   then we're done.
 
+  Once we've written the dirty pages out (and have reset their dirty bits
+  and protection flags), the loom is free to change again, and the rest
+  of the checkpointing process runs on a separate thread, off the files
+  alone:
+
   - Sync the patch files to disk.
   - Verify the patch (because why not?)
   - Write the patch data into the image file (This is idempotent.).
   - Sync the image file.
   - Delete the patchfile and free it.
 
-  Once we've written the dirty pages to disk (and have reset their dirty bits
-  and protection flags), we *could* handle the rest of the checkpointing
-  process in a separate thread, but we'd need to wait until that finishes
-  before we try to make another snapshot.
+  A crash in the meantime leaves the patch on disk, to be verified and
+  applied (or discarded) by u3e_live(), as for a crash during a
+  synchronous save. Exiting normally waits for the commit.
 */
 void
 u3e_save(void)
@@ -1073,41 +2196,44 @@ u3e_save(void)
     return;
   }
 
+  u3e_wait();
+
   if ( !(pat_u = _ce_patch_compose()) ) {
     return;
   }
 
   // u3a_print_memory(stderr, "sync: save", 4096 * pat_u->con_u->pgs_w);
 
-  _ce_patch_sync(pat_u);
-
-  if ( c3n == _ce_patch_verify(pat_u) ) {
-    c3_assert(!"loom: save failed");
-  }
-
-  _ce_patch_apply(pat_u);
+  //  drop any mapping of pages about to be truncated,
+  //  before the loom can grow back into them
+  //
+  _ce_image_shed(pat_u->con_u->nor_w);
 
 #ifdef U3_SNAPSHOT_VALIDATION
+  //  validation compares the images against the loom
+  //
+  _ce_patch_commit(pat_u);
+#else
   {
-    _ce_image_fine(&u3P.nor_u,
-                   u3_Loom,
-                   pag_wiz_i);
+    sigset_t set_u, old_u;
+    c3_i     ret_i;
 
-    _ce_image_fine(&u3P.sou_u,
-                   (u3_Loom + u3C.wor_i) - pag_wiz_i,
-                   -(ssize_t)pag_wiz_i);
-
-    c3_assert(u3P.nor_u.pgs_w == u3K.nor_w);
-    c3_assert(u3P.sou_u.pgs_w == u3K.sou_w);
+    //  leave all signal handling to the main thread
+    //
+    sigfillset(&set_u);
+    pthread_sigmask(SIG_BLOCK, &set_u, &old_u);
+    ret_i = pthread_create(&sav_tid_u, 0, _ce_patch_commit_cb, pat_u);
+    pthread_sigmask(SIG_SETMASK, &old_u, 0);
+
+    if ( 0 != ret_i ) {
+      fprintf(stderr, "loom: save thread: %s\r\n", strerror(ret_i));
+      _ce_patch_commit(pat_u);
+    }
+    else {
+      sav_pat_u = pat_u;
+    }
   }
 #endif
-
-  _ce_image_sync(&u3P.nor_u);
-  _ce_image_sync(&u3P.sou_u);
-  _ce_patch_free(pat_u);
-  _ce_patch_delete();
-
-  u3e_backup(c3n);
 }
 
 /* u3e_live(): start the checkpointing system.
@@ -1132,6 +2258,31 @@ u3e_live(c3_o nuu_o, c3_c* dir_c)
   u3P.sou_u.nam_c = "south";
   u3P.pag_w = u3C.wor_i >> u3a_page;
 
+  //  track dirty memory in larger granules, if requested,
+  //  and (for 2MB granules) ask for the loom to be backed by huge pages
+  //
+  {
+    c3_y bit_y = ( u3C.wag_w & u3o_page_huge ) ? 7
+               : ( u3C.wag_w & u3o_page_big )  ? 2
+               : 0;
+
+    if ( bit_y && (u3P.pag_w & ((1 << bit_y) - 1)) ) {
+      fprintf(stderr, "loom: too small for %zuKB pages\r\n",
+                      (pag_siz_i << bit_y) >> 10);
+      bit_y = 0;
+    }
+
+    gra_y     = bit_y;
+    gra_wiz_i = pag_wiz_i << gra_y;
+    gra_siz_i = pag_siz_i << gra_y;
+
+    _ce_loom_huge(u3_Loom, u3C.wor_i << 2);
+
+    if ( gra_y ) {
+      u3l_log("loom: tracking %zuKB pages", gra_siz_i >> 10);
+    }
+  }
+
   //  XX review dryrun requirements, enable or remove
   //
 #if 0
@@ -1151,16 +2302,36 @@ u3e_live(c3_o nuu_o, c3_c* dir_c)
     else {
       u3_ce_patch* pat_u;
 
+      //  never leave a background commit behind
+      //
+      atexit(_ce_wait_atexit);
+
+      //  load page mugs, before any patch updates them
+      //
+      {
+        c3_c dir_c[8193];
+        snprintf(dir_c, 8192, "%s/.urb/chk", u3P.dir_c);
+        _ce_check_read(dir_c, u3P.mug_w);
+      }
+
       /* Load any patch files; apply them to images.
       */
       if ( 0 != (pat_u = _ce_patch_open()) ) {
+        c3_c dir_c[8193];
+
         _ce_patch_apply(pat_u);
         _ce_image_sync(&u3P.nor_u);
         _ce_image_sync(&u3P.sou_u);
+
+        snprintf(dir_c, 8192, "%s/.urb/chk", u3P.dir_c);
+        _ce_check_write(dir_c);
+
         _ce_patch_free(pat_u);
         _ce_patch_delete();
       }
 
+      _ce_check_trim();
+
       //  detect snapshots from a larger loom
       //
       if ( (u3P.nor_u.pgs_w + u3P.sou_u.pgs_w + 1) >= u3a_pages ) {
@@ -1172,18 +2343,50 @@ u3e_live(c3_o nuu_o, c3_c* dir_c)
       //
       u3e_foul();
 
+      //  track stores with kernel soft-dirty bits instead of page faults
+      //
+      if ( u3C.wag_w & u3o_soft ) {
+        _ce_soft_init();
+      }
+
       /* Write image files to memory; reinstate protection.
       */
       {
-        _ce_image_blit(&u3P.nor_u,
-                       u3_Loom,
-                       pag_wiz_i);
+        if ( u3C.wag_w & u3o_lazy ) {
+          _ce_image_mmap(&u3P.nor_u);
+        }
+        else {
+          _ce_image_blit(&u3P.nor_u,
+                         u3_Loom,
+                         pag_wiz_i);
+        }
 
         _ce_image_blit(&u3P.sou_u,
                        (u3_Loom + u3C.wor_i) - pag_wiz_i,
                        -(ssize_t)pag_wiz_i);
 
-        u3l_log("boot: protected loom");
+        //  forget the stores made while loading
+        //
+        if ( (-1 != pam_i) && (c3n == _ce_soft_clear()) ) {
+          fprintf(stderr, "boot: soft-dirty failed\r\n");
+          exit(1);
+        }
+
+        u3l_log("boot: %s loom%s",
+                ( -1 == pam_i ) ? "protected" : "tracking",
+                ( nor_map_w ) ? " (north on demand)" : "");
+      }
+
+      //  check image integrity, unless that would page everything in
+      //
+      if ( !nor_map_w && (u3P.nor_u.pgs_w || u3P.sou_u.pgs_w) ) {
+        c3_w bad_w = _ce_check_image();
+
+        if ( bad_w ) {
+          fprintf(stderr, "boot: snapshot corrupt (%u pages), "
+                          "restore .urb/bhk or replay\r\n", bad_w);
+          exit(1);
+        }
       }
 
       /* If the images were empty, we are logically booting.
@@ -1219,7 +2422,7 @@ u3e_yolo(void)
     return c3n;
   }
 
-  if ( 0 != mprotect(u3a_into(gar_pag_p), pag_siz_i, PROT_NONE) ) {
+  if ( 0 != mprotect(u3a_into(gar_pag_p), gra_siz_i, PROT_NONE) ) {
     fprintf(stderr, "loom: failed to protect guard page: %s\r\n",
                     strerror(errno));
     c3_assert(0);
@@ -1248,6 +2451,20 @@ u3e_init(void)
 #endif
 }
 
+/* u3e_guard(): guard page location (if any) and recenter count.
+*/
+c3_w
+u3e_guard(u3_post* gar_p)
+{
+#ifdef U3_GUARD_PAGE
+  *gar_p = gar_pag_p;
+  return gar_cen_w;
+#else
+  *gar_p = 0;
+  return 0;
+#endif
+}
+
 /* u3e_ward(): reposition guard page if needed.
 */
 void
@@ -13,12 +13,15 @@
       typedef struct _u3e_line {
         c3_w pag_w;
         c3_w mug_w;
+        c3_w del_w;                         //  1 if a delta against the image
+        c3_w siz_w;                         //  bytes in memory.bin
       } u3e_line;
 
     /* u3e_control: memory change, control file.
     */
       typedef struct _u3e_control {
         c3_w     ver_y;                     //  version number
+        c3_w     vit_w;                     //  pointer compression (u3a_vits)
         c3_w     nor_w;                     //  new page count north
         c3_w     sou_w;                     //  new page count south
         c3_w     pgs_w;                     //  number of changed pages
@@ -49,6 +52,7 @@
         c3_w      pag_w;                     //  number of pages (<= u3a_pages)
         u3e_image nor_u;                     //  north segment
         u3e_image sou_u;                     //  south segment
+        c3_w      mug_w[u3a_pages];          //  image page mugs (0: unknown)
       } u3e_pool;
 
 
@@ -60,7 +64,7 @@
 
   /** Constants.
   **/
-#     define u3e_version 1
+#     define u3e_version 4
 
   /** Functions.
   **/
@@ -74,11 +78,16 @@
       c3_i
       u3e_fault(void* adr_v, c3_i ser_i);
 
-    /* u3e_save():
+    /* u3e_save(): save current changes, committing them in the background.
     */
       void
       u3e_save(void);
 
+    /* u3e_wait(): wait for any background snapshot commit to finish.
+    */
+      void
+      u3e_wait(void);
+
     /* u3e_live(): start the persistence system.  Return c3y if no image.
     */
       c3_o
@@ -99,6 +108,11 @@
       void
       u3e_init(void);
 
+    /* u3e_guard(): guard page location (if any) and recenter count.
+    */
+      c3_w
+      u3e_guard(u3_post* gar_p);
+
     /* u3e_ward(): reposition guard page if needed.
     */
       void
@@ -96,6 +96,10 @@
 //
 static rsignal_jmpbuf u3_Signal;
 
+//  least free space seen at road exits, by depth (see u3m_tide())
+//
+static c3_w tid_w[u3m_tides];
+
 #include "sigsegv.h"
 
 #ifndef SIGSTKSZ
@@ -548,9 +552,9 @@ _pave_south(c3_w* mem_w, c3_w siz_w, c3_w len_w)
 static void
 _pave_home(void)
 {
-  c3_w* mem_w = u3_Loom + 1;
+  c3_w* mem_w = u3_Loom + u3a_walign;
   c3_w  siz_w = c3_wiseof(u3v_home);
-  c3_w  len_w = u3C.wor_i - 1;
+  c3_w  len_w = u3C.wor_i - u3a_walign;
 
   u3H = (void *)_pave_north(mem_w, siz_w, len_w);
   u3H->ver_w = u3v_version;
@@ -569,9 +573,9 @@ _find_home(void)
 {
   //  NB: the home road is always north
   //
-  c3_w* mem_w = u3_Loom + 1;
+  c3_w* mem_w = u3_Loom + u3a_walign;
   c3_w  siz_w = c3_wiseof(u3v_home);
-  c3_w  len_w = u3C.wor_i - 1;
+  c3_w  len_w = u3C.wor_i - u3a_walign;
 
   {
     c3_w ver_w = *((mem_w + len_w) - 1);
@@ -581,6 +585,17 @@ _find_home(void)
                       "have %u, need %u\r\n",
                       ver_w,
                       u3v_version);
+
+      //  images differing only in pointer compression are migrated
+      //  through a rock, which does not depend on the loom layout
+      //
+      if (  (u3v_version_flat == ver_w)
+         || (u3v_version_vits == ver_w) )
+      {
+        fprintf(stderr, "loom: to migrate, run `cram` with the runtime "
+                        "that wrote this image, move .urb/chk aside, "
+                        "then run `queu` with this one\r\n");
+      }
       abort();
     }
   }
@@ -783,6 +798,15 @@ u3m_leap(c3_w pad_w)
   c3_w     len_w;
   u3_road* rod_u;
 
+  /* Start the new heap on an allocation granule.
+  */
+  if ( c3y == u3a_is_north(u3R) ) {
+    u3R->cap_p &= ~(c3_w)(u3a_walign - 1);
+  }
+  else {
+    u3R->cap_p = (u3R->cap_p + (u3a_walign - 1)) & ~(c3_w)(u3a_walign - 1);
+  }
+
   /* Measure the pad - we'll need it.
   */
   {
@@ -841,9 +865,10 @@ u3m_leap(c3_w pad_w)
     u3R->kid_p = u3of(u3_road, rod_u);
   }
 
-  /* Set up the new road.
+  /* Set up the new road, inheriting lite mode.
   */
   {
+    rod_u->how.fag_w = u3R->how.fag_w & u3a_flag_lite;
     u3R = rod_u;
     _pave_parts();
   }
@@ -859,6 +884,39 @@ _print_diff(c3_c* cap_c, c3_w a, c3_w b)
   u3a_print_memory(stderr, cap_c, diff);
 }
 
+/* _cm_deep(): depth of [rod_u] below the home road.
+*/
+static c3_w
+_cm_deep(u3_road* rod_u)
+{
+  c3_w dep_w = 0;
+
+  while ( rod_u->par_p ) {
+    rod_u = u3to(u3_road, rod_u->par_p);
+    dep_w++;
+  }
+
+  return dep_w;
+}
+
+/* _cm_tide_note(): note free space [fre_w] at road depth [dep_w].
+*/
+static void
+_cm_tide_note(c3_w dep_w, c3_w fre_w)
+{
+  dep_w = c3_min(dep_w, u3m_tides - 1);
+  tid_w[dep_w] = c3_min(tid_w[dep_w], fre_w);
+}
+
+/* u3m_tide(): produce and reset free-space low-water marks.
+*/
+void
+u3m_tide(c3_w* out_w)
+{
+  memcpy(out_w, tid_w, sizeof(tid_w));
+  memset(tid_w, 0xff, sizeof(tid_w));
+}
+
 /* u3m_fall(): in u3R, return an inner road to its parent.
 */
 void
@@ -897,6 +955,9 @@ u3m_fall()
   u3to(u3_road, u3R->par_p)->pro.nox_d += u3R->pro.nox_d;
   u3to(u3_road, u3R->par_p)->pro.cel_d += u3R->pro.cel_d;
 
+  c3_w dep_w = _cm_deep(u3R);
+  _cm_tide_note(dep_w, u3a_open(u3R));
+
   /* The new cap is the old hat - it's as simple as that.
   */
   u3to(u3_road, u3R->par_p)->cap_p = u3R->hat_p;
@@ -905,6 +966,8 @@ u3m_fall()
   */
   u3R = u3to(u3_road, u3R->par_p);
   u3R->kid_p = 0;
+
+  _cm_tide_note(dep_w - 1, u3a_open(u3R));
 }
 
 /* u3m_hate(): new, integrated leap mechanism (enter).
@@ -931,6 +994,7 @@ u3m_love(u3_noun pro)
   //
   u3p(u3h_root) byc_p = u3R->byc.har_p;
   u3a_jets      jed_u = u3R->jed;
+  c3_o          lit_o = __(u3R->how.fag_w & u3a_flag_lite);
 
   //  fallback to parent road (child heap on parent's stack)
   //
@@ -938,10 +1002,17 @@ u3m_love(u3_noun pro)
 
   //  copy product and caches off our stack
   //
+  //    in lite mode, junior jet state is simply dropped with the road.
+  //    (bytecode is kept, as recompiling it on every call would cost
+  //    far more than copying it once.)
+  //
   pro   = u3a_take(pro);
-  jed_u = u3j_take(jed_u);
   byc_p = u3n_take(byc_p);
 
+  if ( c3n == lit_o ) {
+    jed_u = u3j_take(jed_u);
+  }
+
   //  pop the stack
   //
   u3R->cap_p = u3R->ear_p;
@@ -949,7 +1020,9 @@ u3m_love(u3_noun pro)
 
   //  integrate junior caches
   //
-  u3j_reap(jed_u);
+  if ( c3n == lit_o ) {
+    u3j_reap(jed_u);
+  }
   u3n_reap(byc_p);
 
   return pro;
@@ -1002,11 +1075,12 @@ u3m_water(c3_w* low_w, c3_w* hig_w)
   *hig_w = u3a_temp(u3R) + c3_wiseof(u3v_home);
 }
 
-/* u3m_soft_top(): top-level safety wrapper.
+/* _cm_soft_top(): top-level safety wrapper, with road flags [fag_w].
 */
-u3_noun
-u3m_soft_top(c3_w    mil_w,                     //  timer ms
+static u3_noun
+_cm_soft_top(c3_w    mil_w,                     //  timer ms
              c3_w    pad_w,                     //  base memory pad
+             c3_w    fag_w,                     //  road flags
              u3_funk fun_f,
              u3_noun   arg)
 {
@@ -1034,6 +1108,7 @@ u3m_soft_top(c3_w    mil_w,                     //  timer ms
   /* Record the cap, and leap.
   */
   u3m_hate(pad_w);
+  u3R->how.fag_w |= fag_w;
 
   /* Trap for ordinary nock exceptions.
   */
@@ -1078,6 +1153,17 @@ u3m_soft_top(c3_w    mil_w,                     //  timer ms
   return pro;
 }
 
+/* u3m_soft_top(): top-level safety wrapper.
+*/
+u3_noun
+u3m_soft_top(c3_w    mil_w,                     //  timer ms
+             c3_w    pad_w,                     //  base memory pad
+             u3_funk fun_f,
+             u3_noun   arg)
+{
+  return _cm_soft_top(mil_w, pad_w, 0, fun_f, arg);
+}
+
 /* u3m_soft_sure(): top-level call assumed correct.
 */
 u3_noun
@@ -1293,18 +1379,19 @@ u3m_grab(u3_noun som, ...)   // terminate with u3_none
   u3a_sweep();
 }
 
-/* u3m_soft(): top-level wrapper.
+/* _cm_soft(): top-level wrapper, with road flags [fag_w].
 **
 ** Produces [0 product] or [%error (list tank)], top last.
 */
-u3_noun
-u3m_soft(c3_w    mil_w,
+static u3_noun
+_cm_soft(c3_w    mil_w,
+         c3_w    fag_w,
          u3_funk fun_f,
          u3_noun   arg)
 {
   u3_noun why;
 
-  why = u3m_soft_top(mil_w, (1 << 20), fun_f, arg);   // 2MB pad
+  why = _cm_soft_top(mil_w, (1 << 20), fag_w, fun_f, arg);   // 2MB pad
 
   if ( 0 == u3h(why) ) {
     return why;
@@ -1373,6 +1460,28 @@ u3m_soft(c3_w    mil_w,
   }
 }
 
+/* u3m_soft(): top-level wrapper.
+**
+** Produces [0 product] or [%error (list tank)], top last.
+*/
+u3_noun
+u3m_soft(c3_w    mil_w,
+         u3_funk fun_f,
+         u3_noun   arg)
+{
+  return _cm_soft(mil_w, 0, fun_f, arg);
+}
+
+/* u3m_soft_lite(): u3m_soft() for short-lived, read-only computation.
+*/
+u3_noun
+u3m_soft_lite(c3_w    mil_w,
+              u3_funk fun_f,
+              u3_noun   arg)
+{
+  return _cm_soft(mil_w, u3a_flag_lite, fun_f, arg);
+}
+
 /* _cm_is_tas(): yes iff som (RETAIN) is @tas.
 */
 static c3_o
@@ -1785,6 +1894,8 @@ u3m_init(size_t len_i)
   _cm_signals();
   _cm_crypto();
 
+  memset(tid_w, 0xff, sizeof(tid_w));
+
   //  make sure GMP uses our malloc.
   //
   mp_set_memory_functions(u3a_malloc, _cm_realloc2, _cm_free2);
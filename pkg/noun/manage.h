@@ -81,6 +81,15 @@
         u3_noun
         u3m_soft(c3_w mil_w, u3_funk fun_f, u3_noun arg);
 
+      /* u3m_soft_lite(): u3m_soft() for short-lived, read-only computation.
+      **
+      **  Jet state accumulated on the inner road (and its descendants)
+      **  is discarded rather than copied up and merged; only the product
+      **  (and bytecode) survive.
+      */
+        u3_noun
+        u3m_soft_lite(c3_w mil_w, u3_funk fun_f, u3_noun arg);
+
       /* u3m_soft_slam: top-level call.
       */
         u3_noun
@@ -124,6 +133,20 @@
         void
         u3m_water(c3_w *low_w, c3_w *hig_w);
 
+      /* u3m_tides: road depths distinguished by u3m_tide().
+      */
+#       define u3m_tides  8
+
+      /* u3m_tide(): produce and reset free-space low-water marks.
+      **
+      **   [tid_w] has u3m_tides entries: the least contiguous free space
+      **   seen when leaving (or returning to) a road at that depth, with
+      **   the last entry covering all deeper roads. 0 is the home road;
+      **   unseen depths are 0xffffffff.
+      */
+        void
+        u3m_tide(c3_w* tid_w);
+
       /* u3m_pretty(): dumb prettyprint to string.  RETAIN.
       */
         c3_c*
@@ -35,7 +35,12 @@
         u3o_dryrun =        0x20,             //  don't touch checkpoint
         u3o_quiet =         0x40,             //  disable ~&
         u3o_hashless =      0x80,             //  disable hashboard
-        u3o_trace =         0x100             //  enables trace dumping
+        u3o_trace =         0x100,            //  enables trace dumping
+        u3o_lazy =          0x200,            //  demand-page snapshot
+        u3o_soft =          0x400,            //  soft-dirty page tracking
+        u3o_page_big =      0x800,            //  64KB dirty-tracking pages
+        u3o_page_huge =     0x1000,           //  2MB dirty-tracking pages
+        u3o_page_out =      0x2000            //  page out cold loom memory
       };
 
   /** Globals.
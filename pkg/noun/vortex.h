@@ -37,7 +37,11 @@
 
   /** Constants.
   **/
-#     define u3v_version 1
+    /* u3v_version: image layout, by pointer compression (see u3a_vits).
+    */
+#     define u3v_version_flat 1
+#     define u3v_version_vits 2
+#     define u3v_version      ( u3a_vits ? u3v_version_vits : u3v_version_flat )
 
   /**  Functions.
   **/
@@ -1,5 +1,6 @@
 /// @file
 
+#include "ivory.h"
 #include "noun.h"
 #include "ur.h"
 #include "vere.h"
@@ -389,6 +390,85 @@ _cue_soft_bench(void)
   u3z(vat);
 }
 
+/* _soft_lite_boot(): replace the loom with the ivory kernel.
+*/
+static void
+_soft_lite_boot(void)
+{
+  c3_d          len_d = u3_Ivory_pill_len;
+  c3_y*         byt_y = u3_Ivory_pill;
+  u3_cue_xeno*  sil_u;
+  u3_weak       pil;
+
+  u3C.wag_w |= u3o_hashless;
+  u3m_boot_lite(1 << 26);
+  sil_u = u3s_cue_xeno_init_with(ur_fib27, ur_fib28);
+  if ( u3_none == (pil = u3s_cue_xeno_with(sil_u, len_d, byt_y)) ) {
+    printf("*** fail _soft_lite_boot 1\n");
+    exit(1);
+  }
+  u3s_cue_xeno_done(sil_u);
+  if ( c3n == u3v_boot_lite(pil) ) {
+    printf("*** fail _soft_lite_boot 2\n");
+    exit(1);
+  }
+}
+
+/* _wish_core(): build a fresh jet-hinted core, registering it on
+**               the current road (the battery differs for every [num]).
+*/
+static u3_noun
+_wish_core(u3_atom num)
+{
+  c3_c txt_c[128];
+
+  snprintf(txt_c, sizeof(txt_c),
+           "~%%  %%bench  ..add  ~  |%%  ++  num  %u  --", num);
+  u3z(num);
+  return u3v_wish(txt_c);
+}
+
+/* _soft_lite_bench(): compare soft and lite roads on junior jet state.
+**
+**   boots the ivory kernel over the loom, so this must run last.
+*/
+static void
+_soft_lite_bench(void)
+{
+  struct timeval b4, f2, d0;
+  c3_w  mil_w, i_w, max_w = 2000;
+
+  _soft_lite_boot();
+
+  fprintf(stderr, "\r\nsoft road microbenchmark:\r\n");
+
+  {
+    gettimeofday(&b4, 0);
+
+    for ( i_w = 0; i_w < max_w; i_w++ ) {
+      u3z(u3m_soft(0, _wish_core, i_w));
+    }
+
+    gettimeofday(&f2, 0);
+    timersub(&f2, &b4, &d0);
+    mil_w = (d0.tv_sec * 1000) + (d0.tv_usec / 1000);
+    fprintf(stderr, "  soft: %u ms\r\n", mil_w);
+  }
+
+  {
+    gettimeofday(&b4, 0);
+
+    for ( i_w = max_w; i_w < (2 * max_w); i_w++ ) {
+      u3z(u3m_soft_lite(0, _wish_core, i_w));
+    }
+
+    gettimeofday(&f2, 0);
+    timersub(&f2, &b4, &d0);
+    mil_w = (d0.tv_sec * 1000) + (d0.tv_usec / 1000);
+    fprintf(stderr, "  soft lite: %u ms\r\n", mil_w);
+  }
+}
+
 /* main(): run all benchmarks
 */
 int
@@ -399,6 +479,7 @@ main(int argc, char* argv[])
   _jam_bench();
   _cue_bench();
   _cue_soft_bench();
+  _soft_lite_bench();
 
   //  GC
   //
@@ -2,6 +2,7 @@
 
 #include "db/lmdb.h"
 
+#include <sys/mman.h>
 #include <sys/stat.h>
 
 #include "c3.h"
@@ -25,6 +26,8 @@ intmax_t mdb_get_filesize(mdb_filehandle_t han_u);
 //
 //      - a metadata store with c3_c (unsigned char) keys
 //      - an event store with contiguous c3_d (uint64_t) keys
+//      - an index store, with an opaque fixed-size entry per event,
+//        written in the same transaction as the event itself
 //
 //    supported operations are as follows
 //
@@ -32,7 +35,85 @@ intmax_t mdb_get_filesize(mdb_filehandle_t han_u);
 //      - read/save metadata
 //      - read the first and last event numbers
 //      - read/save ranges of events
+//      - read/save ranges of index entries
 //
+//    database handles are opened once, when the environment is, and
+//    read-only transactions are not bound to threads (MDB_NOTLS), so
+//    that a u3_lmdb_scan can be reused across threadpool workers.
+//
+
+/* _lmdb_dbis: per-environment database handles.
+*/
+typedef struct _lmdb_dbis {
+  MDB_dbi eve_u;  //  EVENTS
+  MDB_dbi met_u;  //  META
+  MDB_dbi idx_u;  //  INDEX
+} _lmdb_dbis;
+
+/* _lmdb_dbis_open(): open (creating) all databases in [env_u].
+*/
+static c3_o
+_lmdb_dbis_open(MDB_env* env_u)
+{
+  _lmdb_dbis* dbs_u = c3_malloc(sizeof(*dbs_u));
+  MDB_txn*    txn_u;
+  c3_w        ret_w;
+
+  if ( (ret_w = mdb_txn_begin(env_u, 0, 0, &txn_u)) ) {
+    mdb_logerror(stderr, ret_w, "lmdb: init: txn_begin fail");
+    c3_free(dbs_u);
+    return c3n;
+  }
+
+  if (  (ret_w = mdb_dbi_open(txn_u, "EVENTS",
+                              MDB_CREATE | MDB_INTEGERKEY,
+                              &dbs_u->eve_u))
+     || (ret_w = mdb_dbi_open(txn_u, "META", MDB_CREATE, &dbs_u->met_u))
+     || (ret_w = mdb_dbi_open(txn_u, "INDEX",
+                              MDB_CREATE | MDB_INTEGERKEY,
+                              &dbs_u->idx_u)) )
+  {
+    mdb_logerror(stderr, ret_w, "lmdb: init: dbi_open fail");
+    mdb_txn_abort(txn_u);
+    c3_free(dbs_u);
+    return c3n;
+  }
+
+  //  handles opened in a committed transaction are valid env-wide
+  //
+  if ( (ret_w = mdb_txn_commit(txn_u)) ) {
+    mdb_logerror(stderr, ret_w, "lmdb: init: commit fail");
+    c3_free(dbs_u);
+    return c3n;
+  }
+
+  mdb_env_set_userctx(env_u, dbs_u);
+  return c3y;
+}
+
+/* _lmdb_events(): EVENTS database handle.
+*/
+static inline MDB_dbi
+_lmdb_events(MDB_env* env_u)
+{
+  return ((_lmdb_dbis*)mdb_env_get_userctx(env_u))->eve_u;
+}
+
+/* _lmdb_meta(): META database handle.
+*/
+static inline MDB_dbi
+_lmdb_meta(MDB_env* env_u)
+{
+  return ((_lmdb_dbis*)mdb_env_get_userctx(env_u))->met_u;
+}
+
+/* _lmdb_index(): INDEX database handle.
+*/
+static inline MDB_dbi
+_lmdb_index(MDB_env* env_u)
+{
+  return ((_lmdb_dbis*)mdb_env_get_userctx(env_u))->idx_u;
+}
 
 /* u3_lmdb_init(): open lmdb at [pax_c], mmap up to [siz_i].
 */
@@ -47,9 +128,9 @@ u3_lmdb_init(const c3_c* pax_c, size_t siz_i)
     return 0;
   }
 
-  //  Our databases have two tables: META and EVENTS
+  //  Our databases have three tables: META, EVENTS and INDEX
   //
-  if ( (ret_w = mdb_env_set_maxdbs(env_u, 2)) ) {
+  if ( (ret_w = mdb_env_set_maxdbs(env_u, 3)) ) {
     mdb_logerror(stderr, ret_w, "lmdb: failed to set number of databases");
     //  XX dispose env_u
     //
@@ -65,9 +146,9 @@ u3_lmdb_init(const c3_c* pax_c, size_t siz_i)
 
   {
 #   if defined(U3_OS_no_ubc)
-      c3_w ops_w = MDB_WRITEMAP;
+      c3_w ops_w = MDB_WRITEMAP | MDB_NOTLS;
 #   else
-      c3_w ops_w = 0;
+      c3_w ops_w = MDB_NOTLS;
 #   endif
 
     if ( (ret_w = mdb_env_open(env_u, pax_c, ops_w, 0664)) ) {
@@ -78,6 +159,11 @@ u3_lmdb_init(const c3_c* pax_c, size_t siz_i)
     }
   }
 
+  if ( c3n == _lmdb_dbis_open(env_u) ) {
+    mdb_env_close(env_u);
+    return 0;
+  }
+
   return env_u;
 }
 
@@ -86,9 +172,40 @@ u3_lmdb_init(const c3_c* pax_c, size_t siz_i)
 void
 u3_lmdb_exit(MDB_env* env_u)
 {
+  c3_w flg_w;
+
+  //  flush any commits left unsynced by policy
+  //
+  if (  !mdb_env_get_flags(env_u, &flg_w)
+     && (flg_w & (MDB_NOSYNC | MDB_NOMETASYNC)) )
+  {
+    mdb_env_sync(env_u, 1);
+  }
+
+  c3_free(mdb_env_get_userctx(env_u));
   mdb_env_close(env_u);
 }
 
+/* u3_lmdb_set_sync(): set commit durability policy.
+*/
+c3_o
+u3_lmdb_set_sync(MDB_env* env_u, u3_lmdb_sync syn_e)
+{
+  c3_w ret_w;
+
+  if (  (ret_w = mdb_env_set_flags(env_u, MDB_NOSYNC | MDB_NOMETASYNC, 0))
+     || (  (u3_lmdb_sync_meta == syn_e)
+        && (ret_w = mdb_env_set_flags(env_u, MDB_NOMETASYNC, 1)) )
+     || (  (u3_lmdb_sync_none == syn_e)
+        && (ret_w = mdb_env_set_flags(env_u, MDB_NOSYNC, 1)) ) )
+  {
+    mdb_logerror(stderr, ret_w, "lmdb: failed to set sync policy");
+    return c3n;
+  }
+
+  return c3y;
+}
+
 /* u3_lmdb_stat(): print env stats.
 */
 void
@@ -142,26 +259,12 @@ u3_lmdb_gulf(MDB_env* env_u, c3_d* low_d, c3_d* hig_d)
 
   //  create a read-only transaction.
   //
-  //    XX why no MDB_RDONLY?
-  //
-  if ( (ret_w = mdb_txn_begin(env_u, 0, 0, &txn_u)) ) {
+  if ( (ret_w = mdb_txn_begin(env_u, 0, MDB_RDONLY, &txn_u)) ) {
     mdb_logerror(stderr, ret_w, "lmdb: gulf: txn_begin fail");
     return c3n;
   }
 
-  //  open the database in the transaction
-  //
-  {
-    c3_w ops_w = MDB_CREATE | MDB_INTEGERKEY;
-
-    if ( (ret_w = mdb_dbi_open(txn_u, "EVENTS", ops_w, &mdb_u)) ) {
-      mdb_logerror(stderr, ret_w, "lmdb: gulf: dbi_open fail");
-      //  XX confirm
-      //
-      mdb_txn_abort(txn_u);
-      return c3n;
-    }
-  }
+  mdb_u = _lmdb_events(env_u);
 
   {
     MDB_cursor* cur_u;
@@ -225,6 +328,67 @@ u3_lmdb_gulf(MDB_env* env_u, c3_d* low_d, c3_d* hig_d)
   }
 }
 
+/* _lmdb_read_cursor(): read [len_d] events at [eve_d] from [cur_u].
+*/
+static c3_o
+_lmdb_read_cursor(MDB_cursor* cur_u,
+                  void*       ptr_v,
+                  c3_d        eve_d,
+                  c3_d        len_d,
+                  c3_o      (*read_f)(void*, c3_d, size_t, void*))
+{
+  MDB_val val_u;
+  //  set the initial key to [eve_d]
+  //
+  MDB_val key_u = { .mv_size = sizeof(c3_d), .mv_data = &eve_d };
+  c3_w    ret_w;
+  c3_d      i_d;
+
+  //  set the cursor to the position of [eve_d]
+  //
+  if ( (ret_w = mdb_cursor_get(cur_u, &key_u, &val_u, MDB_SET_KEY)) ) {
+    mdb_logerror(stderr, ret_w, "lmdb: read: initial cursor_get failed at %" PRIu64, eve_d);
+    return c3n;
+  }
+
+  //  load up to [len_d] events, iterating forward across the cursor.
+  //
+  for ( i_d = 0; (ret_w != MDB_NOTFOUND) && (i_d < len_d); ++i_d) {
+    c3_d cur_d = (eve_d + i_d);
+    if ( sizeof(c3_d) != key_u.mv_size ) {
+      fprintf(stderr, "lmdb: read: invalid key size\r\n");
+      return c3n;
+    }
+
+    //  sanity check: ensure contiguous event numbers
+    //
+    if ( *(c3_d*)key_u.mv_data != cur_d ) {
+      fprintf(stderr, "lmdb: read gap: expected %" PRIu64
+                      ", received %" PRIu64 "\r\n",
+                      cur_d,
+                      *(c3_d*)key_u.mv_data);
+      return c3n;
+    }
+
+    //  invoke read callback with [val_u]
+    //
+    if ( c3n == read_f(ptr_v, cur_d, val_u.mv_size, val_u.mv_data) ) {
+      return c3n;
+    }
+
+    //  read the next event from the cursor
+    //
+    if (  (ret_w = mdb_cursor_get(cur_u, &key_u, &val_u, MDB_NEXT))
+       && (MDB_NOTFOUND != ret_w) )
+    {
+      mdb_logerror(stderr, ret_w, "lmdb: read: error");
+      return c3n;
+    }
+  }
+
+  return c3y;
+}
+
 /* u3_lmdb_read(): read [len_d] events starting at [eve_d].
 */
 c3_o
@@ -234,9 +398,10 @@ u3_lmdb_read(MDB_env* env_u,
              c3_d     len_d,
              c3_o   (*read_f)(void*, c3_d, size_t, void*))
 {
-  MDB_txn* txn_u;
-  MDB_dbi  mdb_u;
-  c3_w     ret_w;
+  MDB_txn*    txn_u;
+  MDB_cursor* cur_u;
+  c3_w        ret_w;
+  c3_o        ret_o;
 
   //  create a read-only transaction.
   //
@@ -245,111 +410,179 @@ u3_lmdb_read(MDB_env* env_u,
     return c3n;
   }
 
-  //  open the database in the transaction
+  //  creates a cursor to iterate over keys starting at [eve_d]
   //
+  if ( (ret_w = mdb_cursor_open(txn_u, _lmdb_events(env_u), &cur_u)) ) {
+    mdb_logerror(stderr, ret_w, "lmdb: read: cursor_open fail");
+    mdb_txn_abort(txn_u);
+    return c3n;
+  }
+
+  ret_o = _lmdb_read_cursor(cur_u, ptr_v, eve_d, len_d, read_f);
+
+  mdb_cursor_close(cur_u);
+
+  //  read-only transactions are aborted when complete
+  //
+  mdb_txn_abort(txn_u);
+
+  return ret_o;
+}
+
+/* u3_lmdb_scan_init(): create a reusable read-only cursor.
+*/
+c3_o
+u3_lmdb_scan_init(MDB_env* env_u, u3_lmdb_scan* sca_u)
+{
+  c3_w ret_w;
+
+  if ( (ret_w = mdb_txn_begin(env_u, 0, MDB_RDONLY, &sca_u->txn_u)) ) {
+    mdb_logerror(stderr, ret_w, "lmdb: scan: txn_begin fail");
+    return c3n;
+  }
+
+  if ( (ret_w = mdb_cursor_open(sca_u->txn_u,
+                                _lmdb_events(env_u),
+                                &sca_u->cur_u)) )
   {
-    c3_w ops_w = MDB_CREATE | MDB_INTEGERKEY;
+    mdb_logerror(stderr, ret_w, "lmdb: scan: cursor_open fail");
+    mdb_txn_abort(sca_u->txn_u);
+    return c3n;
+  }
 
-    if ( (ret_w = mdb_dbi_open(txn_u, "EVENTS", ops_w, &mdb_u)) ) {
-      mdb_logerror(stderr, ret_w, "lmdb: read: dbi_open fail");
-      //  XX confirm
-      //
-      mdb_txn_abort(txn_u);
-      return c3n;
-    }
+  //  release the snapshot until the first read
+  //
+  mdb_txn_reset(sca_u->txn_u);
+
+  return c3y;
+}
+
+/* u3_lmdb_scan_read(): read [len_d] events starting at [eve_d],
+**                      from a fresh snapshot.
+*/
+c3_o
+u3_lmdb_scan_read(u3_lmdb_scan* sca_u,
+                  void*         ptr_v,
+                  c3_d          eve_d,
+                  c3_d          len_d,
+                  c3_o        (*read_f)(void*, c3_d, size_t, void*))
+{
+  c3_w ret_w;
+  c3_o ret_o;
+
+  if ( (ret_w = mdb_txn_renew(sca_u->txn_u)) ) {
+    mdb_logerror(stderr, ret_w, "lmdb: scan: txn_renew fail");
+    return c3n;
   }
 
+  if ( (ret_w = mdb_cursor_renew(sca_u->txn_u, sca_u->cur_u)) ) {
+    mdb_logerror(stderr, ret_w, "lmdb: scan: cursor_renew fail");
+    mdb_txn_reset(sca_u->txn_u);
+    return c3n;
+  }
+
+  ret_o = _lmdb_read_cursor(sca_u->cur_u, ptr_v, eve_d, len_d, read_f);
+
+  //  release the snapshot, so as not to pin pages against the writer
+  //
+  mdb_txn_reset(sca_u->txn_u);
 
+  return ret_o;
+}
+
+/* u3_lmdb_scan_advise(): advise the kernel that about [siz_i] bytes of
+**                        events, starting at [eve_d], will be read soon.
+**
+**   events are appended in order, so their pages are mostly contiguous.
+*/
+void
+u3_lmdb_scan_advise(u3_lmdb_scan* sca_u, c3_d eve_d, size_t siz_i)
+{
+#ifdef MADV_WILLNEED
+  MDB_env*    env_u = mdb_txn_env(sca_u->txn_u);
+  MDB_val     key_u = { .mv_size = sizeof(c3_d), .mv_data = &eve_d };
+  MDB_val     val_u;
+  MDB_envinfo mei_u;
+  MDB_stat    mst_u;
+
+  if ( mdb_txn_renew(sca_u->txn_u) ) {
+    return;
+  }
+
+  if (  !mdb_cursor_renew(sca_u->txn_u, sca_u->cur_u)
+     && !mdb_cursor_get(sca_u->cur_u, &key_u, &val_u, MDB_SET_KEY)
+     && !mdb_env_info(env_u, &mei_u)
+     && !mdb_env_stat(env_u, &mst_u) )
   {
-    MDB_cursor* cur_u;
-    MDB_val     val_u;
-    //  set the initial key to [eve_d]
-    //
-    MDB_val     key_u = { .mv_size = sizeof(c3_d), .mv_data = &eve_d };
+    c3_y*  map_y = mei_u.me_mapaddr;
+    c3_y*  end_y = map_y + (mst_u.ms_psize * (mei_u.me_last_pgno + 1));
+    c3_y*  beg_y = (c3_y*)val_u.mv_data;
+    size_t pag_i = mst_u.ms_psize;
 
-    //  creates a cursor to iterate over keys starting at [eve_d]
+    //  page-align, clamped to the used portion of the map
     //
-    if ( (ret_w = mdb_cursor_open(txn_u, mdb_u, &cur_u)) ) {
-      mdb_logerror(stderr, ret_w, "lmdb: read: cursor_open fail");
-      //  XX confirm
-      //
-      mdb_txn_abort(txn_u);
-      return c3n;
-    }
+    beg_y = map_y + (((size_t)(beg_y - map_y) / pag_i) * pag_i);
 
-    //  set the cursor to the position of [eve_d]
-    //
-    if ( (ret_w = mdb_cursor_get(cur_u, &key_u, &val_u, MDB_SET_KEY)) ) {
-      mdb_logerror(stderr, ret_w, "lmdb: read: initial cursor_get failed at %" PRIu64, eve_d);
-      mdb_cursor_close(cur_u);
-      //  XX confirm
-      //
-      mdb_txn_abort(txn_u);
-      return c3n;
+    if ( (beg_y >= map_y) && (beg_y < end_y) ) {
+      siz_i = c3_min(siz_i, (size_t)(end_y - beg_y));
+      madvise(beg_y, siz_i, MADV_WILLNEED);
     }
+  }
 
-    //  load up to [len_d] events, iterating forward across the cursor.
-    //
-    {
-      c3_o ret_o = c3y;
-      c3_d   i_d;
-
-      for ( i_d = 0; (ret_w != MDB_NOTFOUND) && (i_d < len_d); ++i_d) {
-        c3_d cur_d = (eve_d + i_d);
-        if ( sizeof(c3_d) != key_u.mv_size ) {
-          fprintf(stderr, "lmdb: read: invalid key size\r\n");
-          ret_o = c3n;
-          break;
-        }
-
-        //  sanity check: ensure contiguous event numbers
-        //
-        if ( *(c3_d*)key_u.mv_data != cur_d ) {
-          fprintf(stderr, "lmdb: read gap: expected %" PRIu64
-                          ", received %" PRIu64 "\r\n",
-                          cur_d,
-                          *(c3_d*)key_u.mv_data);
-          ret_o = c3n;
-          break;
-        }
+  mdb_txn_reset(sca_u->txn_u);
+#endif
+}
 
-        //  invoke read callback with [val_u]
-        //
-        if ( c3n == read_f(ptr_v, cur_d, val_u.mv_size, val_u.mv_data) ) {
-          ret_o = c3n;
-          break;
-        }
+/* u3_lmdb_scan_done(): dispose reusable cursor.
+*/
+void
+u3_lmdb_scan_done(u3_lmdb_scan* sca_u)
+{
+  mdb_cursor_close(sca_u->cur_u);
+  mdb_txn_abort(sca_u->txn_u);
+}
 
-        //  read the next event from the cursor
-        //
-        if (  (ret_w = mdb_cursor_get(cur_u, &key_u, &val_u, MDB_NEXT))
-           && (MDB_NOTFOUND != ret_w) )
-        {
-          mdb_logerror(stderr, ret_w, "lmdb: read: error");
-          ret_o = c3n;
-          break;
-        }
-      }
+/* _lmdb_put_index(): put [len_d] index entries of [idx_i] bytes at [eve_d].
+*/
+static c3_o
+_lmdb_put_index(MDB_txn* txn_u,
+                MDB_dbi  mdb_u,
+                c3_d     eve_d,
+                c3_d     len_d,
+                c3_y*    idx_y,
+                size_t   idx_i)
+{
+  c3_w ret_w;
+  c3_d key_d, i_d;
 
-      mdb_cursor_close(cur_u);
+  for ( i_d = 0; i_d < len_d; ++i_d) {
+    key_d = eve_d + i_d;
 
-      //  read-only transactions are aborted when complete
-      //
-      mdb_txn_abort(txn_u);
+    {
+      MDB_val key_u = { .mv_size = sizeof(c3_d), .mv_data = &key_d };
+      MDB_val val_u = { .mv_size = idx_i, .mv_data = idx_y + (i_d * idx_i) };
 
-      return ret_o;
+      if ( (ret_w = mdb_put(txn_u, mdb_u, &key_u, &val_u, 0)) ) {
+        mdb_logerror(stderr, ret_w, "lmdb: index write failed on event %" PRIu64, key_d);
+        return c3n;
+      }
     }
   }
+
+  return c3y;
 }
 
-/* u3_lmdb_save(): save [len_d] events starting at [eve_d].
+/* u3_lmdb_save(): save [len_d] events starting at [eve_d],
+**                 with an optional index entry of [idx_i] bytes for each.
 */
 c3_o
 u3_lmdb_save(MDB_env* env_u,
              c3_d     eve_d,               //  first event
              c3_d     len_d,               //  number of events
              void**   byt_p,               //  array of bytes
-             size_t*  siz_i)               //  array of lengths
+             size_t*  siz_i,               //  array of lengths
+             void*    idx_v,               //  index entries, or 0
+             size_t   idx_i)               //  index entry length
 {
   MDB_txn* txn_u;
   MDB_dbi  mdb_u;
@@ -362,17 +595,7 @@ u3_lmdb_save(MDB_env* env_u,
     return c3n;
   }
 
-  //  opens the database in the transaction
-  //
-  {
-    c3_w ops_w = MDB_CREATE | MDB_INTEGERKEY;
-
-    if ( (ret_w = mdb_dbi_open(txn_u, "EVENTS", ops_w, &mdb_u)) ) {
-      mdb_logerror(stderr, ret_w, "lmdb: write: dbi_open fail");
-      mdb_txn_abort(txn_u);
-      return c3n;
-    }
-  }
+  mdb_u = _lmdb_events(env_u);
 
   //  write every event in the batch
   //
@@ -397,6 +620,16 @@ u3_lmdb_save(MDB_env* env_u,
     }
   }
 
+  //  index the batch atomically with it
+  //
+  if (  idx_v
+     && (c3n == _lmdb_put_index(txn_u, _lmdb_index(env_u),
+                                eve_d, len_d, idx_v, idx_i)) )
+  {
+    mdb_txn_abort(txn_u);
+    return c3n;
+  }
+
   //  commit transaction
   //
   if ( (ret_w = mdb_txn_commit(txn_u)) ) {
@@ -407,6 +640,102 @@ u3_lmdb_save(MDB_env* env_u,
   return c3y;
 }
 
+/* u3_lmdb_save_index(): save [len_d] index entries starting at [eve_d].
+*/
+c3_o
+u3_lmdb_save_index(MDB_env* env_u,
+                   c3_d     eve_d,
+                   c3_d     len_d,
+                   void*    idx_v,
+                   size_t   idx_i)
+{
+  MDB_txn* txn_u;
+  c3_w     ret_w;
+
+  if ( (ret_w = mdb_txn_begin(env_u, 0, 0, &txn_u)) ) {
+    mdb_logerror(stderr, ret_w, "lmdb: index write: txn_begin fail");
+    return c3n;
+  }
+
+  if ( c3n == _lmdb_put_index(txn_u, _lmdb_index(env_u),
+                              eve_d, len_d, idx_v, idx_i) )
+  {
+    mdb_txn_abort(txn_u);
+    return c3n;
+  }
+
+  if ( (ret_w = mdb_txn_commit(txn_u)) ) {
+    mdb_logerror(stderr, ret_w, "lmdb: index write: commit failed");
+    return c3n;
+  }
+
+  return c3y;
+}
+
+/* u3_lmdb_read_index(): read index entries for events [eve_d, eve_d + len_d).
+**
+**   unlike events, index entries may be missing; only those present
+**   are passed to [read_f].
+*/
+c3_o
+u3_lmdb_read_index(MDB_env* env_u,
+                   void*    ptr_v,
+                   c3_d     eve_d,
+                   c3_d     len_d,
+                   c3_o   (*read_f)(void*, c3_d, size_t, void*))
+{
+  MDB_txn*    txn_u;
+  MDB_cursor* cur_u;
+  MDB_val     key_u = { .mv_size = sizeof(c3_d), .mv_data = &eve_d };
+  MDB_val     val_u;
+  c3_d        las_d = eve_d + len_d;
+  c3_w        ret_w;
+  c3_o        ret_o = c3y;
+
+  if ( (ret_w = mdb_txn_begin(env_u, 0, MDB_RDONLY, &txn_u)) ) {
+    mdb_logerror(stderr, ret_w, "lmdb: index read: txn_begin fail");
+    return c3n;
+  }
+
+  if ( (ret_w = mdb_cursor_open(txn_u, _lmdb_index(env_u), &cur_u)) ) {
+    mdb_logerror(stderr, ret_w, "lmdb: index read: cursor_open fail");
+    mdb_txn_abort(txn_u);
+    return c3n;
+  }
+
+  ret_w = mdb_cursor_get(cur_u, &key_u, &val_u, MDB_SET_RANGE);
+
+  while ( !ret_w ) {
+    c3_d key_d;
+
+    if ( sizeof(c3_d) != key_u.mv_size ) {
+      fprintf(stderr, "lmdb: index read: invalid key size\r\n");
+      ret_o = c3n;
+      break;
+    }
+
+    key_d = *(c3_d*)key_u.mv_data;
+
+    if (  (key_d >= las_d)
+       || (c3n == (ret_o = read_f(ptr_v, key_d, val_u.mv_size, val_u.mv_data))) )
+    {
+      break;
+    }
+
+    ret_w = mdb_cursor_get(cur_u, &key_u, &val_u, MDB_NEXT);
+  }
+
+  if ( ret_w && (MDB_NOTFOUND != ret_w) ) {
+    mdb_logerror(stderr, ret_w, "lmdb: index read: error");
+    ret_o = c3n;
+  }
+
+  mdb_cursor_close(cur_u);
+  mdb_txn_abort(txn_u);
+
+  return ret_o;
+}
+
 /* u3_lmdb_read_meta(): read by string from the META db.
 */
 void
@@ -426,13 +755,7 @@ u3_lmdb_read_meta(MDB_env*    env_u,
     return read_f(ptr_v, 0, 0);
   }
 
-  //  open the database in the transaction
-  //
-  if ( (ret_w =  mdb_dbi_open(txn_u, "META", 0, &mdb_u)) ) {
-    mdb_logerror(stderr, ret_w, "lmdb: meta read: dbi_open fail");
-    mdb_txn_abort(txn_u);
-    return read_f(ptr_v, 0, 0);
-  }
+  mdb_u = _lmdb_meta(env_u);
 
   //  read by string key, invoking callback with result
   {
@@ -440,7 +763,11 @@ u3_lmdb_read_meta(MDB_env*    env_u,
     MDB_val val_u;
 
     if ( (ret_w = mdb_get(txn_u, mdb_u, &key_u, &val_u)) ) {
-      mdb_logerror(stderr, ret_w, "lmdb: read failed");
+      //  missing keys are expected, and handled by the caller
+      //
+      if ( MDB_NOTFOUND != ret_w ) {
+        mdb_logerror(stderr, ret_w, "lmdb: read failed");
+      }
       mdb_txn_abort(txn_u);
       return read_f(ptr_v, 0, 0);
     }
@@ -473,13 +800,7 @@ u3_lmdb_save_meta(MDB_env*    env_u,
     return c3n;
   }
 
-  //  opens the database in the transaction
-  //
-  if ( (ret_w = mdb_dbi_open(txn_u, "META", MDB_CREATE, &mdb_u)) ) {
-    mdb_logerror(stderr, ret_w, "lmdb: meta write: dbi_open fail");
-    mdb_txn_abort(txn_u);
-    return c3n;
-  }
+  mdb_u = _lmdb_meta(env_u);
 
   //  put value by string key
   //
@@ -529,16 +850,7 @@ u3_lmdb_walk_init(MDB_env*      env_u,
     mdb_logerror(stderr, ret_w, "lmdb: read txn_begin fail");
     return c3n;
   }
-  //  open the database in the transaction
-  //
-  ops_w = MDB_CREATE | MDB_INTEGERKEY;
-  if ( (ret_w = mdb_dbi_open(itr_u->txn_u, "EVENTS", ops_w, &itr_u->mdb_u)) ) {
-    mdb_logerror(stderr, ret_w, "lmdb: read: dbi_open fail");
-    //  XX confirm
-    //
-    mdb_txn_abort(itr_u->txn_u);
-    return c3n;
-  }
+  itr_u->mdb_u = _lmdb_events(env_u);
 
   //  creates a cursor to iterate over keys starting at [eve_d]
   //
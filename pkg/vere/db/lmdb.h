@@ -19,6 +19,23 @@
       c3_d        las_d;  //  final event number, inclusive
     } u3_lmdb_walk;
 
+    /* u3_lmdb_sync: commit durability policy.
+    */
+    typedef enum {
+      u3_lmdb_sync_full = 0,  //  sync data and metadata on every commit
+      u3_lmdb_sync_meta = 1,  //  defer metadata sync to the next commit
+      u3_lmdb_sync_none = 2   //  leave syncing to the OS
+    } u3_lmdb_sync;
+
+    /* u3_lmdb_scan: reusable read-only event cursor.
+    **
+    **   may be used from any thread, but only one at a time.
+    */
+    typedef struct _u3_lmdb_scan {
+      MDB_txn*    txn_u;  //  transaction handle, reset between reads
+      MDB_cursor* cur_u;  //  db cursor
+    } u3_lmdb_scan;
+
     /* u3_lmdb_init(): open lmdb at [pax_c], mmap up to [siz_i].
     */
       MDB_env*
@@ -29,6 +46,11 @@
       void
       u3_lmdb_exit(MDB_env* env_u);
 
+    /* u3_lmdb_set_sync(): set commit durability policy.
+    */
+      c3_o
+      u3_lmdb_set_sync(MDB_env* env_u, u3_lmdb_sync syn_e);
+
     /* u3_lmdb_stat(): print env stats.
     */
       void
@@ -48,14 +70,62 @@
                    c3_d     len_d,
                    c3_o  (*read_f)(void*, c3_d, size_t  , void*));
 
-    /* u3_lmdb_save(): save [len_d] events starting at [eve_d].
+    /* u3_lmdb_scan_init(): create a reusable read-only cursor.
+    */
+      c3_o
+      u3_lmdb_scan_init(MDB_env* env_u, u3_lmdb_scan* sca_u);
+
+    /* u3_lmdb_scan_read(): read [len_d] events starting at [eve_d],
+    **                      from a fresh snapshot.
+    */
+      c3_o
+      u3_lmdb_scan_read(u3_lmdb_scan* sca_u,
+                        void*         ptr_v,
+                        c3_d          eve_d,
+                        c3_d          len_d,
+                        c3_o        (*read_f)(void*, c3_d, size_t, void*));
+
+    /* u3_lmdb_scan_advise(): advise the kernel that about [siz_i] bytes of
+    **                        events, starting at [eve_d], will be read soon.
+    */
+      void
+      u3_lmdb_scan_advise(u3_lmdb_scan* sca_u, c3_d eve_d, size_t siz_i);
+
+    /* u3_lmdb_scan_done(): dispose reusable cursor.
+    */
+      void
+      u3_lmdb_scan_done(u3_lmdb_scan* sca_u);
+
+    /* u3_lmdb_save(): save [len_d] events starting at [eve_d],
+    **                 with an optional index entry of [idx_i] bytes for each.
     */
       c3_o
       u3_lmdb_save(MDB_env* env_u,
                    c3_d     eve_d,
                    c3_d     len_d,
                    void**   byt_p,
-                   size_t*  siz_i);
+                   size_t*  siz_i,
+                   void*    idx_v,
+                   size_t   idx_i);
+
+    /* u3_lmdb_save_index(): save [len_d] index entries starting at [eve_d].
+    */
+      c3_o
+      u3_lmdb_save_index(MDB_env* env_u,
+                         c3_d     eve_d,
+                         c3_d     len_d,
+                         void*    idx_v,
+                         size_t   idx_i);
+
+    /* u3_lmdb_read_index(): read index entries for events
+    **                       [eve_d, eve_d + len_d), skipping missing entries.
+    */
+      c3_o
+      u3_lmdb_read_index(MDB_env* env_u,
+                         void*    ptr_v,
+                         c3_d     eve_d,
+                         c3_d     len_d,
+                         c3_o   (*read_f)(void*, c3_d, size_t, void*));
 
     /* u3_lmdb_read_meta(): read by string from the META db.
     */
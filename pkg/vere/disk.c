@@ -1,7 +1,9 @@
 /// @file
 
 #include "noun.h"
+#include "ur.h"
 #include "vere.h"
+#include "zlib.h"
 #include "db/lmdb.h"
 
 struct _cd_read {
@@ -17,11 +19,125 @@ struct _cd_save {
   c3_o             ret_o;               //  result
   c3_d             eve_d;               //  first event
   c3_d             len_d;               //  number of events
+  c3_l*            mug_l;               //  array of mugs
+  u3_noun*           job;               //  array of events (borrowed)
   c3_y**           byt_y;               //  array of bytes
   size_t*          siz_i;               //  array of lengths
+  c3_w             pen_w;               //  pending jam slices
+  struct _cd_jam*  jam_u;               //  jam slices
+  c3_w             ver_w;               //  value format
+  c3_y*            dic_y;               //  deflate dictionary
+  size_t           dic_i;               //  dictionary length
+  c3_y*            idx_y;               //  index entries
   struct _u3_disk* log_u;
 };
 
+struct _cd_dict {
+  uv_work_t        ted_u;               //  training thread
+  c3_o             ret_o;               //  result
+  c3_d             fir_d;               //  first v2 event
+  c3_d             eve_d;               //  first sample
+  c3_d             len_d;               //  number of samples
+  c3_d             sam_d;               //  samples read
+  c3_y**           byt_y;               //  array of jammed samples
+  size_t*          siz_i;               //  array of lengths
+  c3_y*            dic_y;               //  trained dictionary
+  size_t           dic_i;               //  dictionary length
+  struct _u3_disk* log_u;
+};
+
+struct _cd_jam {
+  uv_work_t        ted_u;               //  jam thread
+  c3_d             fir_d;               //  first index
+  c3_d             len_d;               //  number of events
+  struct _cd_save* req_u;
+};
+
+struct _cd_span {
+  MDB_env*         mdb_u;               //  epoch environment
+  c3_d             fir_d;               //  first v2 event
+  c3_d             eve_d;               //  first event
+  c3_d             las_d;               //  last event
+};
+
+struct _cd_scan {
+  uv_mutex_t       mut_u;               //  guards work and totals
+  struct _cd_span* spa_u;               //  epochs to verify
+  c3_w             len_w;               //  number of epochs
+  c3_w             cur_w;               //  current epoch
+  c3_d             nex_d;               //  next event in epoch
+  const c3_y*      dic_y;               //  deflate dictionary
+  size_t           dic_i;               //  dictionary length
+  c3_o             fix_o;               //  write missing entries
+  c3_o             ret_o;               //  no read failures
+  c3_d             red_d;               //  events verified
+  c3_d             mis_d;               //  events unindexed
+  c3_d             bad_d;               //  events mismatched
+  c3_d             fix_d;               //  entries written
+};
+
+struct _cd_chunk {
+  struct _cd_scan* sca_u;
+  c3_d             fir_d;               //  first v2 event
+  c3_d             eve_d;               //  first event
+  c3_d             len_d;               //  number of events
+  c3_y*            idx_y;               //  index entries
+  c3_y*            has_y;               //  entry status
+  c3_d             red_d;               //  events verified
+  c3_d             mis_d;               //  events unindexed
+  c3_d             bad_d;               //  events mismatched
+};
+
+/* DISK_CUE_SLICE: events decoded per main-loop turn when reading
+**                 (raw reads are delivered in one pass).
+*/
+#define DISK_CUE_SLICE 100ULL
+
+/* DISK_JAM_SLICE: max parallel jam slices per commit.
+*/
+#define DISK_JAM_SLICE 4ULL
+
+/* DISK_VERSION: current event-log value format.
+**
+**   v1: [mug:4 jam]
+**   v2: [mug:4 0x0 jam] or [mug:4 0x1 len:4 deflate(jam)]
+**
+**   v2 events are compressed with a preset dictionary, trained once
+**   from DISK_DICT_EVENTS recent events and stored at META "dict".
+**   an upgraded log keeps its v1 events; the first v2 event is stored
+**   at META "first-v2".
+*/
+#define DISK_VERSION      2
+#define DISK_DICT_EVENTS  2048ULL
+#define DISK_DICT_SIZE    32768
+#define DISK_DICT_SEG     32
+#define DISK_DICT_PREFIX  1024
+#define DISK_ZLIB_LEVEL   3
+
+/* DISK_INDEX_SIZE: bytes per event-log index entry.
+**
+**   [mug:4 crc:4 len:8 siz:8], little-endian: the event mug, the crc32
+**   and length of the jammed event, and the length of the stored value.
+**   entries are committed with their events, in the INDEX db.
+*/
+#define DISK_INDEX_SIZE   24
+
+/* DISK_SCAN_BATCH: events per unit of work when verifying the index.
+*/
+#define DISK_SCAN_BATCH   65536ULL
+
+/* DISK_MAP_SIZE: lmdb mapsize, per epoch.
+**
+**   arbitrarily choosing 1TB as a "large enough" mapsize, per the docs:
+**   "[..] on 64-bit there is no penalty for making this huge (say 1TB)."
+**   500 GiB is as large as musl on aarch64 wants to allow.
+*/
+#if (defined(U3_CPU_aarch64) && defined(U3_OS_linux))
+#  define DISK_MAP_SIZE  0x7d00000000ULL
+#else
+#  define DISK_MAP_SIZE  0x10000000000ULL
+#endif
+
 #undef VERBOSE_DISK
 #undef DISK_TRACE_JAM
 #undef DISK_TRACE_CUE
@@ -29,6 +145,21 @@ struct _cd_save {
 static void
 _disk_commit(u3_disk* log_u);
 
+static c3_o
+_disk_save_meta(MDB_env* mdb_u, const c3_c* key_c, u3_atom dat);
+
+static void
+_disk_dict_start(u3_disk* log_u);
+
+static u3_epoc*
+_disk_epoc_find(u3_disk* log_u, c3_d eve_d);
+
+static c3_o
+_disk_epoc_load(u3_disk* log_u, u3_epoc* epo_u);
+
+static void
+_disk_epoc_idle(u3_disk* log_u, u3_epoc* cur_u);
+
 /* _disk_free_save(): free write batch
 */
 static void
@@ -38,8 +169,12 @@ _disk_free_save(struct _cd_save* req_u)
     c3_free(req_u->byt_y[req_u->len_d]);
   }
 
+  c3_free(req_u->mug_l);
+  c3_free(req_u->job);
   c3_free(req_u->byt_y);
   c3_free(req_u->siz_i);
+  c3_free(req_u->jam_u);
+  c3_free(req_u->idx_y);
   c3_free(req_u);
 }
 
@@ -99,6 +234,7 @@ _disk_commit_done(struct _cd_save* req_u)
 
   _disk_free_save(req_u);
 
+  _disk_dict_start(log_u);
   _disk_commit(log_u);
 }
 
@@ -129,460 +265,2263 @@ _disk_commit_cb(uv_work_t* ted_u)
                               req_u->eve_d,
                               req_u->len_d,
                               (void**)req_u->byt_y, // XX safe?
-                              req_u->siz_i);
+                              req_u->siz_i,
+                              req_u->idx_y,
+                              DISK_INDEX_SIZE);
 }
 
-/* _disk_commit_start(): queue async event-batch write.
+/* _disk_ur_from_loom(): copy [a] off-loom into [rot_u], without mutation.
+**
+**   NB: safe off the main thread, so long as [a] is retained
+**   and nothing reallocates the loom.
 */
-static void
-_disk_commit_start(struct _cd_save* req_u)
+static ur_nref
+_disk_ur_from_loom(ur_root_t* rot_u, u3_noun a)
 {
-  u3_disk* log_u = req_u->log_u;
+  //  stack of cells and (once the head is copied) head refs
+  //
+  struct {
+    ur_nref   hed;
+    u3a_cell* cel_u;
+  }*      fam_u;
+  c3_w    pre_w = ur_fib10;
+  c3_w    siz_w = ur_fib11;
+  c3_w    fil_w = 0;
+  ur_nref   ref;
+
+  fam_u = c3_malloc(siz_w * sizeof(*fam_u));
+
+  while ( 1 ) {
+    //  descend into heads, until we find an atom
+    //
+    while ( c3n == u3a_is_atom(a) ) {
+      u3a_cell* cel_u = u3a_to_ptr(a);
+
+      if ( fil_w == siz_w ) {
+        c3_w nex_w = pre_w + siz_w;
+        fam_u = c3_realloc(fam_u, nex_w * sizeof(*fam_u));
+        pre_w = siz_w;
+        siz_w = nex_w;
+      }
 
-  c3_assert( c3n == log_u->ted_o );
-  log_u->ted_o = c3y;
-  log_u->ted_u.data = req_u;
+      fam_u[fil_w].hed   = 0;
+      fam_u[fil_w].cel_u = cel_u;
+      fil_w++;
+      a = cel_u->hed;
+    }
 
-  //  queue asynchronous work to happen on another thread
-  //
-  uv_queue_work(u3L, &log_u->ted_u, _disk_commit_cb,
-                                    _disk_commit_after_cb);
+    if ( c3y == u3a_is_cat(a) ) {
+      ref = (ur_nref)a;
+    }
+    else {
+      u3a_atom* vat_u = u3a_to_ptr(a);
+
+      if ( 2 >= vat_u->len_w ) {
+        c3_d val_d = (c3_d)vat_u->buf_w[0];
+
+        if ( 2 == vat_u->len_w ) {
+          val_d |= ((c3_d)vat_u->buf_w[1]) << 32;
+        }
+
+        ref = ur_coin64(rot_u, val_d);
+      }
+      else {
+        //  XX assumes little-endian
+        //
+        ref = ur_coin_bytes(rot_u, ((c3_d)vat_u->len_w) << 2,
+                                   (c3_y*)vat_u->buf_w);
+      }
+    }
+
+    //  ascend through completed tails, consing as we go
+    //
+    while ( fil_w && fam_u[fil_w - 1].hed ) {
+      fil_w--;
+      ref = ur_cons(rot_u, fam_u[fil_w].hed - 1, ref);
+    }
+
+    if ( !fil_w ) {
+      break;
+    }
+
+    //  head complete, continue into the tail
+    //  (refs are stored incremented, as zero is a valid nref)
+    //
+    fam_u[fil_w - 1].hed = ref + 1;
+    a = fam_u[fil_w - 1].cel_u->tel;
+  }
+
+  c3_free(fam_u);
+  return ref;
 }
 
-/* _disk_serialize_v1(): serialize events in format v1.
+/* _disk_index_etch(): write index entry for jammed event [jam_y].
 */
-static c3_w
-_disk_serialize_v1(u3_fact* tac_u, c3_y** out_y)
+static void
+_disk_index_etch(c3_y*       idx_y,
+                 c3_l        mug_l,
+                 c3_d        len_d,
+                 const c3_y* jam_y,
+                 size_t      siz_i)
 {
-#ifdef DISK_TRACE_JAM
-  u3t_event_trace("king disk jam", 'B');
-#endif
+  c3_w crc_w = 0;
+  c3_d siz_d = siz_i;
+  c3_w i_w;
 
+  //  zlib's crc32 takes lengths as uInt
+  //
   {
-    u3_atom mat = u3qe_jam(tac_u->job);
-    c3_w  len_w = u3r_met(3, mat);
-    c3_y* dat_y = c3_malloc(4 + len_w);
-    dat_y[0] = tac_u->mug_l & 0xff;
-    dat_y[1] = (tac_u->mug_l >> 8) & 0xff;
-    dat_y[2] = (tac_u->mug_l >> 16) & 0xff;
-    dat_y[3] = (tac_u->mug_l >> 24) & 0xff;
-    u3r_bytes(0, len_w, dat_y + 4, mat);
-
-#ifdef DISK_TRACE_JAM
-    u3t_event_trace("king disk jam", 'E');
-#endif
+    const c3_y* byt_y = jam_y;
+    c3_d        lef_d = len_d;
+
+    while ( lef_d ) {
+      uInt max_i = (uInt)c3_min(lef_d, 0x40000000ULL);
+      crc_w = crc32(crc_w, byt_y, max_i);
+      byt_y += max_i;
+      lef_d -= max_i;
+    }
+  }
 
-    u3z(mat);
+  for ( i_w = 0; i_w < 4; i_w++ ) {
+    idx_y[i_w]     = (mug_l >> (8 * i_w)) & 0xff;
+    idx_y[4 + i_w] = (crc_w >> (8 * i_w)) & 0xff;
+  }
 
-    *out_y = dat_y;
-    return len_w + 4;
+  for ( i_w = 0; i_w < 8; i_w++ ) {
+    idx_y[8 + i_w]  = (len_d >> (8 * i_w)) & 0xff;
+    idx_y[16 + i_w] = (siz_d >> (8 * i_w)) & 0xff;
   }
 }
 
-/* _disk_batch(): create a write batch
+/* _disk_index_sift(): read index entry.
 */
-static struct _cd_save*
-_disk_batch(u3_disk* log_u, c3_d len_d)
+static void
+_disk_index_sift(const c3_y* idx_y,
+                 c3_l*       mug_l,
+                 c3_w*       crc_w,
+                 c3_d*       len_d,
+                 c3_d*       siz_d)
 {
-  u3_fact* tac_u = log_u->put_u.ext_u;
+  c3_w i_w;
 
-  c3_assert( (1ULL + log_u->dun_d) == tac_u->eve_d );
-  c3_assert( log_u->sen_d == log_u->put_u.ent_u->eve_d );
+  *mug_l = *crc_w = 0;
+  *len_d = *siz_d = 0;
 
-  struct _cd_save* req_u = c3_malloc(sizeof(*req_u));
-  req_u->log_u = log_u;
-  req_u->ret_o = c3n;
-  req_u->eve_d = tac_u->eve_d;
-  req_u->len_d = len_d;
-  req_u->byt_y = c3_malloc(len_d * sizeof(c3_y*));
-  req_u->siz_i = c3_malloc(len_d * sizeof(size_t));
+  for ( i_w = 0; i_w < 4; i_w++ ) {
+    *mug_l |= (c3_l)idx_y[i_w] << (8 * i_w);
+    *crc_w |= (c3_w)idx_y[4 + i_w] << (8 * i_w);
+  }
 
-  for ( c3_d i_d = 0ULL; i_d < len_d; ++i_d) {
-    c3_assert( (req_u->eve_d + i_d) == tac_u->eve_d );
+  for ( i_w = 0; i_w < 8; i_w++ ) {
+    *len_d |= (c3_d)idx_y[8 + i_w] << (8 * i_w);
+    *siz_d |= (c3_d)idx_y[16 + i_w] << (8 * i_w);
+  }
+}
 
-    req_u->siz_i[i_d] = _disk_serialize_v1(tac_u, &req_u->byt_y[i_d]);
+/* _disk_serialize_v1(): serialize jammed event in format v1.
+*/
+static size_t
+_disk_serialize_v1(c3_l mug_l, c3_d len_d, c3_y* jam_y, c3_y** out_y)
+{
+  c3_y* dat_y = c3_malloc(4 + len_d);
 
-    tac_u = tac_u->nex_u;
-  }
+  dat_y[0] = mug_l & 0xff;
+  dat_y[1] = (mug_l >> 8) & 0xff;
+  dat_y[2] = (mug_l >> 16) & 0xff;
+  dat_y[3] = (mug_l >> 24) & 0xff;
+  memcpy(dat_y + 4, jam_y, len_d);
 
-  return req_u;
+  *out_y = dat_y;
+  return len_d + 4;
 }
 
-/* _disk_commit(): commit all available events, if idle.
+/* _disk_serialize_v2(): serialize jammed event in format v2.
+**
+**   deflates with [dic_y] if present and profitable.
 */
-static void
-_disk_commit(u3_disk* log_u)
+static size_t
+_disk_serialize_v2(z_stream*   zes_u,
+                   const c3_y* dic_y,
+                   size_t      dic_i,
+                   c3_l        mug_l,
+                   c3_d        len_d,
+                   c3_y*       jam_y,
+                   c3_y**      out_y)
 {
-  if (  (c3n == log_u->ted_o)
-     && (log_u->sen_d > log_u->dun_d) )
-  {
-    c3_d len_d = log_u->sen_d - log_u->dun_d;
-    struct _cd_save* req_u = _disk_batch(log_u, len_d);
+  c3_y* dat_y;
 
-#ifdef VERBOSE_DISK
-    if ( 1ULL == len_d ) {
-      fprintf(stderr, "disk: (%" PRIu64 "): commit: request\r\n",
-                      req_u->eve_d);
-    }
-    else {
-      fprintf(stderr, "disk: (%" PRIu64 "-%" PRIu64 "): commit: request\r\n",
-                      req_u->eve_d,
-                      (req_u->eve_d + len_d - 1ULL));
+  if ( dic_y && (0xffffffffULL >= len_d) ) {
+    uLong bon = deflateBound(zes_u, len_d);
+
+    dat_y = c3_malloc(9 + bon);
+
+    deflateReset(zes_u);
+    deflateSetDictionary(zes_u, dic_y, dic_i);
+
+    zes_u->next_in   = jam_y;
+    zes_u->avail_in  = len_d;
+    zes_u->next_out  = dat_y + 9;
+    zes_u->avail_out = bon;
+
+    if (  (Z_STREAM_END == deflate(zes_u, Z_FINISH))
+       && ((zes_u->total_out + 4) < len_d) )
+    {
+      dat_y[0] = mug_l & 0xff;
+      dat_y[1] = (mug_l >> 8) & 0xff;
+      dat_y[2] = (mug_l >> 16) & 0xff;
+      dat_y[3] = (mug_l >> 24) & 0xff;
+      dat_y[4] = 1;
+      dat_y[5] = len_d & 0xff;
+      dat_y[6] = (len_d >> 8) & 0xff;
+      dat_y[7] = (len_d >> 16) & 0xff;
+      dat_y[8] = (len_d >> 24) & 0xff;
+
+      *out_y = dat_y;
+      return 9 + zes_u->total_out;
     }
-#endif
 
-    _disk_commit_start(req_u);
+    c3_free(dat_y);
   }
+
+  dat_y = c3_malloc(5 + len_d);
+  dat_y[0] = mug_l & 0xff;
+  dat_y[1] = (mug_l >> 8) & 0xff;
+  dat_y[2] = (mug_l >> 16) & 0xff;
+  dat_y[3] = (mug_l >> 24) & 0xff;
+  dat_y[4] = 0;
+  memcpy(dat_y + 5, jam_y, len_d);
+
+  *out_y = dat_y;
+  return len_d + 5;
 }
 
-/* u3_disk_plan(): enqueue completed event for persistence.
+/* _disk_deserialize(): normalize stored event [val_y] to [mug:4 jam].
+**
+**   NB: safe off the main thread.
 */
-void
-u3_disk_plan(u3_disk* log_u, u3_fact* tac_u)
+static c3_o
+_disk_deserialize(c3_d        fir_d,
+                  const c3_y* dic_y,
+                  size_t      dic_i,
+                  c3_d        eve_d,
+                  size_t      val_i,
+                  const c3_y* val_y,
+                  size_t*     out_i,
+                  c3_y**      out_y)
 {
-  c3_assert( (1ULL + log_u->sen_d) == tac_u->eve_d );
-  log_u->sen_d++;
+  c3_y* dat_y;
 
-  if ( !log_u->put_u.ent_u ) {
-    c3_assert( !log_u->put_u.ext_u );
-    log_u->put_u.ent_u = log_u->put_u.ext_u = tac_u;
+  //  v1 event, copy as-is
+  //
+  if ( eve_d < fir_d ) {
+    dat_y = c3_malloc(val_i);
+    memcpy(dat_y, val_y, val_i);
+    *out_i = val_i;
+    *out_y = dat_y;
+    return c3y;
   }
-  else {
-    log_u->put_u.ent_u->nex_u = tac_u;
-    log_u->put_u.ent_u = tac_u;
+
+  if ( 5 > val_i ) {
+    fprintf(stderr, "disk: (%" PRIu64 "): value too short\r\n", eve_d);
+    return c3n;
   }
 
-  _disk_commit(log_u);
+  switch ( val_y[4] ) {
+    default: {
+      fprintf(stderr, "disk: (%" PRIu64 "): unknown encoding %u\r\n",
+                      eve_d, val_y[4]);
+      return c3n;
+    }
+
+    case 0: {
+      dat_y = c3_malloc(val_i - 1);
+      memcpy(dat_y, val_y, 4);
+      memcpy(dat_y + 4, val_y + 5, val_i - 5);
+      *out_i = val_i - 1;
+      *out_y = dat_y;
+      return c3y;
+    }
+
+    case 1: {
+      z_stream zes_u = {0};
+      c3_w     len_w;
+      c3_i     ret_i;
+
+      if ( 9 > val_i ) {
+        fprintf(stderr, "disk: (%" PRIu64 "): value too short\r\n", eve_d);
+        return c3n;
+      }
+
+      if ( !dic_y ) {
+        fprintf(stderr, "disk: (%" PRIu64 "): missing dictionary\r\n", eve_d);
+        return c3n;
+      }
+
+      len_w = val_y[5]
+            ^ (val_y[6] <<  8)
+            ^ (val_y[7] << 16)
+            ^ (val_y[8] << 24);
+      dat_y = c3_malloc(4 + (size_t)len_w);
+      memcpy(dat_y, val_y, 4);
+
+      if ( Z_OK != inflateInit2(&zes_u, -15) ) {
+        c3_free(dat_y);
+        return c3n;
+      }
+
+      inflateSetDictionary(&zes_u, dic_y, dic_i);
+
+      zes_u.next_in   = (c3_y*)val_y + 9;
+      zes_u.avail_in  = val_i - 9;
+      zes_u.next_out  = dat_y + 4;
+      zes_u.avail_out = len_w;
+
+      ret_i = inflate(&zes_u, Z_FINISH);
+      inflateEnd(&zes_u);
+
+      if ( (Z_STREAM_END != ret_i) || (len_w != zes_u.total_out) ) {
+        fprintf(stderr, "disk: (%" PRIu64 "): inflate failed\r\n", eve_d);
+        c3_free(dat_y);
+        return c3n;
+      }
+
+      *out_i = 4 + (size_t)len_w;
+      *out_y = dat_y;
+      return c3y;
+    }
+  }
 }
 
-/* u3_disk_boot_plan(): enqueue boot sequence, without autocommit.
+/* _disk_jam_cb(): off the main thread, serialize a slice.
 */
-void
-u3_disk_boot_plan(u3_disk* log_u, u3_noun job)
+static void
+_disk_jam_cb(uv_work_t* ted_u)
 {
-  //  NB, boot mugs are 0
-  //
-  u3_fact* tac_u = u3_fact_init(++log_u->sen_d, 0, job);
+  struct _cd_jam*  jam_u = ted_u->data;
+  struct _cd_save* req_u = jam_u->req_u;
+  ur_root_t*       rot_u = ur_root_init();
+  ur_jam_t*        jam_t = ur_jam_init(rot_u);
+  z_stream         zes_u = {0};
+  c3_o             def_o = c3n;
+  c3_d             i_d, len_d;
+  c3_y*            byt_y;
+
+  if (  req_u->dic_y
+     && (Z_OK == deflateInit2(&zes_u, DISK_ZLIB_LEVEL, Z_DEFLATED,
+                              -15, 8, Z_DEFAULT_STRATEGY)) )
+  {
+    def_o = c3y;
+  }
 
-  if ( !log_u->put_u.ent_u ) {
-    c3_assert( !log_u->put_u.ext_u );
-    c3_assert( 1ULL == log_u->sen_d );
+  for ( i_d = jam_u->fir_d; i_d < (jam_u->fir_d + jam_u->len_d); i_d++ ) {
+    c3_l mug_l = req_u->mug_l[i_d];
 
-    log_u->put_u.ent_u = log_u->put_u.ext_u = tac_u;
+    ur_jam_with(jam_t, _disk_ur_from_loom(rot_u, req_u->job[i_d]),
+                &len_d, &byt_y);
+
+    if ( 1 == req_u->ver_w ) {
+      req_u->siz_i[i_d] = _disk_serialize_v1(mug_l, len_d, byt_y,
+                                             &req_u->byt_y[i_d]);
+    }
+    else {
+      req_u->siz_i[i_d] = _disk_serialize_v2(&zes_u,
+                                             (c3y == def_o) ? req_u->dic_y : 0,
+                                             req_u->dic_i,
+                                             mug_l, len_d, byt_y,
+                                             &req_u->byt_y[i_d]);
+    }
+
+    _disk_index_etch(req_u->idx_y + (i_d * DISK_INDEX_SIZE),
+                     mug_l, len_d, byt_y, req_u->siz_i[i_d]);
+
+    c3_free(byt_y);
   }
-  else {
-    log_u->put_u.ent_u->nex_u = tac_u;
-    log_u->put_u.ent_u = tac_u;
+
+  if ( c3y == def_o ) {
+    deflateEnd(&zes_u);
   }
 
-#ifdef VERBOSE_DISK
-  fprintf(stderr, "disk: (%" PRIu64 "): db boot plan\r\n", tac_u->eve_d);
-#endif
+  ur_jam_done(jam_t);
+  ur_root_free(rot_u);
 }
 
-/* u3_disk_boot_save(): commit boot sequence.
+/* _disk_jam_after_cb(): on the main thread, write batch once jammed.
 */
-void
-u3_disk_boot_save(u3_disk* log_u)
+static void
+_disk_jam_after_cb(uv_work_t* ted_u, c3_i sas_i)
 {
-  c3_assert( !log_u->dun_d );
-  _disk_commit(log_u);
+  struct _cd_jam*  jam_u = ted_u->data;
+  struct _cd_save* req_u = jam_u->req_u;
+  u3_disk*         log_u = req_u->log_u;
+
+  c3_assert( req_u->pen_w );
+
+  if ( !--req_u->pen_w ) {
+    //  queue asynchronous write to happen on another thread
+    //
+    uv_queue_work(u3L, &log_u->ted_u, _disk_commit_cb,
+                                      _disk_commit_after_cb);
+  }
 }
 
+/* _disk_commit_start(): queue async event-batch jam and write.
+*/
 static void
-_disk_read_free(u3_read* red_u)
+_disk_commit_start(struct _cd_save* req_u)
 {
-  //  free facts (if the read failed)
+  u3_disk* log_u = req_u->log_u;
+  c3_d     sli_d = c3_min(req_u->len_d, DISK_JAM_SLICE);
+  c3_d     fir_d = 0;
+  c3_d     i_d;
+
+  c3_assert( c3n == log_u->ted_o );
+  log_u->ted_o = c3y;
+  log_u->ted_u.data = req_u;
+
+  req_u->pen_w = sli_d;
+  req_u->jam_u = c3_calloc(sli_d * sizeof(*req_u->jam_u));
+
+  //  fan out serialization across the threadpool
   //
-  {
-    u3_fact* tac_u = red_u->ext_u;
-    u3_fact* nex_u;
+  for ( i_d = 0; i_d < sli_d; i_d++ ) {
+    struct _cd_jam* jam_u = &req_u->jam_u[i_d];
 
-    while ( tac_u ) {
-      nex_u = tac_u->nex_u;
-      u3_fact_free(tac_u);
-      tac_u = nex_u;
-    }
+    jam_u->req_u = req_u;
+    jam_u->fir_d = fir_d;
+    jam_u->len_d = (req_u->len_d / sli_d)
+                 + ((i_d < (req_u->len_d % sli_d)) ? 1 : 0);
+    jam_u->ted_u.data = jam_u;
+    fir_d += jam_u->len_d;
+
+    uv_queue_work(u3L, &jam_u->ted_u, _disk_jam_cb, _disk_jam_after_cb);
   }
 
-  c3_free(red_u);
+  c3_assert( fir_d == req_u->len_d );
 }
 
-/* _disk_read_close_cb():
+/* _disk_dict_hash(): FNV-1a hash of a dictionary segment.
 */
-static void
-_disk_read_close_cb(uv_handle_t* had_u)
+static c3_d
+_disk_dict_hash(const c3_y* byt_y)
 {
-  u3_read* red_u = had_u->data;
-  _disk_read_free(red_u);
+  c3_d has_d = 0xcbf29ce484222325ULL;
+
+  for ( c3_w i_w = 0; i_w < DISK_DICT_SEG; i_w++ ) {
+    has_d ^= byt_y[i_w];
+    has_d *= 0x100000001b3ULL;
+  }
+
+  return has_d;
 }
 
-static void
-_disk_read_close(u3_read* red_u)
+/* _cd_seg: dictionary segment frequency.
+*/
+struct _cd_seg {
+  c3_d        has_d;                    //  hash
+  c3_w        cnt_w;                    //  occurrences
+  const c3_y* byt_y;                    //  first occurrence
+};
+
+/* _disk_dict_cmp(): order segments by ascending frequency.
+*/
+static c3_i
+_disk_dict_cmp(const void* a_v, const void* b_v)
 {
-  u3_disk* log_u = red_u->log_u;
+  const struct _cd_seg* a_u = a_v;
+  const struct _cd_seg* b_u = b_v;
 
-  //  unlink request
+  if ( a_u->cnt_w != b_u->cnt_w ) {
+    return ( a_u->cnt_w < b_u->cnt_w ) ? -1 : 1;
+  }
+
+  return ( a_u->has_d < b_u->has_d ) ? -1 : ( a_u->has_d > b_u->has_d );
+}
+
+/* _disk_dict_train(): build a deflate dictionary from [len_d] samples.
+**
+**   counts fixed-size segments from the head of each sample (where
+**   ova are most alike), and lays out the most frequent segments last,
+**   closest to the data they will match.
+*/
+static c3_y*
+_disk_dict_train(c3_d len_d, c3_y** byt_y, size_t* siz_i, size_t* dic_i)
+{
+  c3_y*           dic_y = c3_malloc(DISK_DICT_SIZE);
+  size_t          pos_i = DISK_DICT_SIZE;
+  c3_d            tot_d = 0;
+  c3_d            sel_d = 0;
+  c3_d            msk_d = 1;
+  c3_d            i_d, j_d;
+  struct _cd_seg* tab_u;
+
+  for ( i_d = 0; i_d < len_d; i_d++ ) {
+    tot_d += c3_min(siz_i[i_d], DISK_DICT_PREFIX) / DISK_DICT_SEG;
+  }
+
+  //  open-addressed, at most half full
   //
-  {
-    if ( red_u->pre_u ) {
-      red_u->pre_u->nex_u = red_u->nex_u;
+  while ( msk_d < (2 * tot_d) ) {
+    msk_d <<= 1;
+  }
+
+  tab_u = c3_calloc(msk_d * sizeof(*tab_u));
+  msk_d--;
+
+  for ( i_d = 0; i_d < len_d; i_d++ ) {
+    size_t max_i = c3_min(siz_i[i_d], DISK_DICT_PREFIX);
+
+    for ( j_d = 0; (j_d + DISK_DICT_SEG) <= max_i; j_d += DISK_DICT_SEG ) {
+      const c3_y* seg_y = byt_y[i_d] + j_d;
+      c3_d        has_d = _disk_dict_hash(seg_y);
+      c3_d        idx_d = has_d & msk_d;
+
+      while (  tab_u[idx_d].byt_y
+            && (  (has_d != tab_u[idx_d].has_d)
+               || memcmp(seg_y, tab_u[idx_d].byt_y, DISK_DICT_SEG) ) )
+      {
+        idx_d = (idx_d + 1) & msk_d;
+      }
+
+      if ( !tab_u[idx_d].byt_y ) {
+        tab_u[idx_d].has_d = has_d;
+        tab_u[idx_d].byt_y = seg_y;
+      }
+
+      tab_u[idx_d].cnt_w++;
     }
-    else {
-      log_u->red_u = red_u->nex_u;
+  }
+
+  //  compact repeated segments, sort by frequency
+  //
+  for ( j_d = 0; j_d <= msk_d; j_d++ ) {
+    if ( 1 < tab_u[j_d].cnt_w ) {
+      tab_u[sel_d++] = tab_u[j_d];
+    }
+  }
+
+  qsort(tab_u, sel_d, sizeof(*tab_u), _disk_dict_cmp);
+
+  while ( sel_d-- && (pos_i >= DISK_DICT_SEG) ) {
+    pos_i -= DISK_DICT_SEG;
+    memcpy(dic_y + pos_i, tab_u[sel_d].byt_y, DISK_DICT_SEG);
+  }
+
+  c3_free(tab_u);
+
+  //  nothing repeats, fall back to the most recent samples
+  //
+  for ( i_d = len_d; (DISK_DICT_SIZE == pos_i) && i_d--; ) {
+    size_t cop_i = c3_min(siz_i[i_d], DISK_DICT_PREFIX);
+
+    while ( cop_i && pos_i ) {
+      dic_y[--pos_i] = byt_y[i_d][--cop_i];
+    }
+  }
+
+  *dic_i = DISK_DICT_SIZE - pos_i;
+
+  if ( !*dic_i ) {
+    c3_free(dic_y);
+    return 0;
+  }
+
+  memmove(dic_y, dic_y + pos_i, *dic_i);
+  return dic_y;
+}
+
+/* _disk_dict_read_cb(): lmdb read callback, collect training samples.
+**
+**   NB: runs off the main thread.
+*/
+static c3_o
+_disk_dict_read_cb(void* ptr_v, c3_d eve_d, size_t val_i, void* val_p)
+{
+  struct _cd_dict* dit_u = ptr_v;
+  size_t           len_i;
+  c3_y*            dat_y;
+
+  if (  (c3n == _disk_deserialize(dit_u->fir_d, 0, 0, eve_d,
+                                  val_i, val_p, &len_i, &dat_y))
+     || (4 > len_i) )
+  {
+    return c3n;
+  }
+
+  //  sample the jam, without the mug
+  //
+  memmove(dat_y, dat_y + 4, len_i - 4);
+  dit_u->byt_y[dit_u->sam_d] = dat_y;
+  dit_u->siz_i[dit_u->sam_d] = len_i - 4;
+  dit_u->sam_d++;
+
+  return c3y;
+}
+
+/* _disk_dict_cb(): off the main thread, train and save dictionary.
+*/
+static void
+_disk_dict_cb(uv_work_t* ted_u)
+{
+  struct _cd_dict* dit_u = ted_u->data;
+  MDB_env*         mdb_u = dit_u->log_u->mdb_u;
+  c3_d             low_d, hig_d;
+
+  dit_u->ret_o = c3n;
+
+  if (  (c3n == u3_lmdb_gulf(mdb_u, &low_d, &hig_d))
+     || (low_d > dit_u->eve_d) )
+  {
+    return;
+  }
+
+  if ( c3n == u3_lmdb_read(mdb_u, dit_u, dit_u->eve_d, dit_u->len_d,
+                           _disk_dict_read_cb) )
+  {
+    return;
+  }
+
+  dit_u->dic_y = _disk_dict_train(dit_u->sam_d, dit_u->byt_y,
+                                  dit_u->siz_i, &dit_u->dic_i);
+
+  if ( dit_u->dic_y ) {
+    dit_u->ret_o = u3_lmdb_save_meta(mdb_u, "dict",
+                                     dit_u->dic_i, dit_u->dic_y);
+  }
+}
+
+/* _disk_dict_after_cb(): on the main thread, install dictionary.
+*/
+static void
+_disk_dict_after_cb(uv_work_t* ted_u, c3_i sas_i)
+{
+  struct _cd_dict* dit_u = ted_u->data;
+  u3_disk*         log_u = dit_u->log_u;
+
+  log_u->fom_u.tra_o = c3n;
+
+  if ( c3y == dit_u->ret_o ) {
+    log_u->fom_u.dic_y = dit_u->dic_y;
+    log_u->fom_u.dic_i = dit_u->dic_i;
+  }
+  else {
+    c3_free(dit_u->dic_y);
+    log_u->fom_u.tri_d = log_u->dun_d + DISK_DICT_EVENTS;
+  }
+
+  while ( dit_u->sam_d-- ) {
+    c3_free(dit_u->byt_y[dit_u->sam_d]);
+  }
+
+  c3_free(dit_u->byt_y);
+  c3_free(dit_u->siz_i);
+  c3_free(dit_u);
+}
+
+/* _disk_dict_start(): train a dictionary from recent events, if needed.
+*/
+static void
+_disk_dict_start(u3_disk* log_u)
+{
+  if (  (1 == log_u->fom_u.ver_w)
+     || log_u->fom_u.dic_y
+     || (c3y == log_u->fom_u.tra_o)
+     || (log_u->dun_d < log_u->fom_u.tri_d) )
+  {
+    return;
+  }
+
+  {
+    struct _cd_dict* dit_u = c3_calloc(sizeof(*dit_u));
+
+    dit_u->log_u = log_u;
+    dit_u->fir_d = log_u->fom_u.fir_d;
+    dit_u->len_d = DISK_DICT_EVENTS;
+    dit_u->eve_d = 1ULL + log_u->dun_d - DISK_DICT_EVENTS;
+    dit_u->byt_y = c3_calloc(DISK_DICT_EVENTS * sizeof(c3_y*));
+    dit_u->siz_i = c3_calloc(DISK_DICT_EVENTS * sizeof(size_t));
+    dit_u->ted_u.data = dit_u;
+
+    log_u->fom_u.tra_o = c3y;
+
+    uv_queue_work(u3L, &dit_u->ted_u, _disk_dict_cb, _disk_dict_after_cb);
+  }
+}
+
+/* _disk_format_upgrade(): write v2 events from here on.
+**
+**   NB: must be called while no write is in progress.
+*/
+static c3_o
+_disk_format_upgrade(u3_disk* log_u)
+{
+  c3_d fir_d = 1ULL + log_u->dun_d;
+
+  //  NB: order matters, "first-v2" is ignored until "version" is updated
+  //
+  if (  (c3n == _disk_save_meta(log_u->mdb_u, "first-v2", u3i_chub(fir_d)))
+     || (c3n == _disk_save_meta(log_u->mdb_u, "version", DISK_VERSION)) )
+  {
+    fprintf(stderr, "disk: failed to upgrade event log format\r\n");
+    return c3n;
+  }
+
+  log_u->fom_u.ver_w = DISK_VERSION;
+  log_u->fom_u.fir_d = fir_d;
+  log_u->fom_u.tri_d = fir_d + DISK_DICT_EVENTS;
+
+  return c3y;
+}
+
+/* _disk_batch(): create a write batch
+*/
+static struct _cd_save*
+_disk_batch(u3_disk* log_u, c3_d len_d)
+{
+  u3_fact* tac_u = log_u->put_u.ext_u;
+
+  c3_assert( (1ULL + log_u->dun_d) == tac_u->eve_d );
+  c3_assert( log_u->sen_d == log_u->put_u.ent_u->eve_d );
+
+  struct _cd_save* req_u = c3_calloc(sizeof(*req_u));
+  req_u->log_u = log_u;
+  req_u->ret_o = c3n;
+  req_u->eve_d = tac_u->eve_d;
+  req_u->len_d = len_d;
+  req_u->mug_l = c3_malloc(len_d * sizeof(c3_l));
+  req_u->job   = c3_malloc(len_d * sizeof(u3_noun));
+  req_u->byt_y = c3_calloc(len_d * sizeof(c3_y*));
+  req_u->siz_i = c3_calloc(len_d * sizeof(size_t));
+  req_u->idx_y = c3_malloc(len_d * DISK_INDEX_SIZE);
+  req_u->ver_w = log_u->fom_u.ver_w;
+  req_u->dic_y = log_u->fom_u.dic_y;
+  req_u->dic_i = log_u->fom_u.dic_i;
+
+  //  facts are retained in the write queue until the commit completes
+  //
+  for ( c3_d i_d = 0ULL; i_d < len_d; ++i_d) {
+    c3_assert( (req_u->eve_d + i_d) == tac_u->eve_d );
+
+    req_u->mug_l[i_d] = tac_u->mug_l;
+    req_u->job[i_d]   = tac_u->job;
+
+    tac_u = tac_u->nex_u;
+  }
+
+  return req_u;
+}
+
+/* _disk_commit_timer_cb(): group-commit delay expired.
+*/
+static void
+_disk_commit_timer_cb(uv_timer_t* tim_u)
+{
+  u3_disk* log_u = tim_u->data;
+
+  log_u->gru_u.due_o = c3y;
+  _disk_commit(log_u);
+}
+
+/* _disk_commit(): commit all available events, if idle.
+**
+**   with a group-commit delay, waits for more events until the delay
+**   expires or enough are pending.
+*/
+static void
+_disk_commit(u3_disk* log_u)
+{
+  if (  (c3n == log_u->ted_o)
+     && (log_u->sen_d > log_u->dun_d) )
+  {
+    c3_d len_d = log_u->sen_d - log_u->dun_d;
+    struct _cd_save* req_u;
+
+    if (  log_u->gru_u.del_w
+       && (c3n == log_u->gru_u.due_o)
+       && (!log_u->gru_u.max_d || (len_d < log_u->gru_u.max_d)) )
+    {
+      if ( !uv_is_active((uv_handle_t*)log_u->gru_u.tim_u) ) {
+        uv_timer_start(log_u->gru_u.tim_u, _disk_commit_timer_cb,
+                       log_u->gru_u.del_w, 0);
+      }
+      return;
+    }
+
+    log_u->gru_u.due_o = c3n;
+    uv_timer_stop(log_u->gru_u.tim_u);
+
+    if (  (1 == log_u->fom_u.ver_w)
+       && (c3n == _disk_format_upgrade(log_u)) )
+    {
+      log_u->cb_u.write_bail_f(log_u->cb_u.ptr_v, log_u->sen_d);
+      return;
+    }
+
+    req_u = _disk_batch(log_u, len_d);
+
+#ifdef VERBOSE_DISK
+    if ( 1ULL == len_d ) {
+      fprintf(stderr, "disk: (%" PRIu64 "): commit: request\r\n",
+                      req_u->eve_d);
+    }
+    else {
+      fprintf(stderr, "disk: (%" PRIu64 "-%" PRIu64 "): commit: request\r\n",
+                      req_u->eve_d,
+                      (req_u->eve_d + len_d - 1ULL));
+    }
+#endif
+
+    _disk_commit_start(req_u);
+  }
+}
+
+/* u3_disk_plan(): enqueue completed event for persistence.
+*/
+void
+u3_disk_plan(u3_disk* log_u, u3_fact* tac_u)
+{
+  c3_assert( (1ULL + log_u->sen_d) == tac_u->eve_d );
+  log_u->sen_d++;
+  log_u->gru_u.dep_d = c3_max(log_u->gru_u.dep_d,
+                              log_u->sen_d - log_u->dun_d);
+
+  if ( !log_u->put_u.ent_u ) {
+    c3_assert( !log_u->put_u.ext_u );
+    log_u->put_u.ent_u = log_u->put_u.ext_u = tac_u;
+  }
+  else {
+    log_u->put_u.ent_u->nex_u = tac_u;
+    log_u->put_u.ent_u = tac_u;
+  }
+
+  _disk_commit(log_u);
+}
+
+/* u3_disk_boot_plan(): enqueue boot sequence, without autocommit.
+*/
+void
+u3_disk_boot_plan(u3_disk* log_u, u3_noun job)
+{
+  //  NB, boot mugs are 0
+  //
+  u3_fact* tac_u = u3_fact_init(++log_u->sen_d, 0, job);
+
+  if ( !log_u->put_u.ent_u ) {
+    c3_assert( !log_u->put_u.ext_u );
+    c3_assert( 1ULL == log_u->sen_d );
+
+    log_u->put_u.ent_u = log_u->put_u.ext_u = tac_u;
+  }
+  else {
+    log_u->put_u.ent_u->nex_u = tac_u;
+    log_u->put_u.ent_u = tac_u;
+  }
+
+#ifdef VERBOSE_DISK
+  fprintf(stderr, "disk: (%" PRIu64 "): db boot plan\r\n", tac_u->eve_d);
+#endif
+}
+
+/* u3_disk_boot_save(): commit boot sequence.
+*/
+void
+u3_disk_boot_save(u3_disk* log_u)
+{
+  c3_assert( !log_u->dun_d );
+  _disk_commit(log_u);
+}
+
+static void
+_disk_read_free(u3_read* red_u)
+{
+  //  free facts (if the read failed)
+  //
+  {
+    u3_fact* tac_u = red_u->ext_u;
+    u3_fact* nex_u;
+
+    while ( tac_u ) {
+      nex_u = tac_u->nex_u;
+      u3_fact_free(tac_u);
+      tac_u = nex_u;
+    }
+  }
+
+  //  free raw events (if the read was cancelled)
+  //
+  while ( red_u->cur_d < red_u->red_d ) {
+    c3_free(red_u->byt_y[red_u->cur_d++]);
+  }
+
+  if ( red_u->sca_u ) {
+    u3_lmdb_scan_done(red_u->sca_u);
+    c3_free(red_u->sca_u);
+  }
+
+  c3_free(red_u->byt_y);
+  c3_free(red_u->siz_i);
+  c3_free(red_u);
+}
+
+/* _disk_read_close_cb():
+*/
+static void
+_disk_read_close_cb(uv_handle_t* had_u)
+{
+  u3_read* red_u = had_u->data;
+  _disk_read_free(red_u);
+}
+
+/* _disk_read_close(): unlink and dispose read.
+**
+**   produces c3n if the read thread is still running.
+*/
+static c3_o
+_disk_read_close(u3_read* red_u)
+{
+  u3_disk* log_u = red_u->log_u;
+
+  //  unlink request
+  //
+  {
+    if ( red_u->pre_u ) {
+      red_u->pre_u->nex_u = red_u->nex_u;
+    }
+    else {
+      log_u->red_u = red_u->nex_u;
+    }
+
+    if ( red_u->nex_u ) {
+      red_u->nex_u->pre_u = red_u->pre_u;
+    }
+  }
+
+  //  the read thread owns [red_u], close in _disk_read_after_cb()
+  //
+  if ( c3y == red_u->ted_o ) {
+    red_u->can_o = c3y;
+    return ( 0 > uv_cancel(&red_u->req_u) ) ? c3n : c3y;
+  }
+
+  uv_close(&red_u->had_u, _disk_read_close_cb);
+  return c3y;
+}
+
+/* _disk_read_done(): finalize reads, in order, invoking callback.
+*/
+static void
+_disk_read_done(u3_read* red_u)
+{
+  u3_disk* log_u = red_u->log_u;
+
+  red_u->don_o = c3y;
+
+  //  deliver from the oldest read, stopping at one still in progress
+  //
+  while ( 1 ) {
+    u3_info pay_u;
+
+    red_u = log_u->red_u;
+
+    while ( red_u && red_u->nex_u ) {
+      red_u = red_u->nex_u;
+    }
+
+    if ( !red_u || (c3n == red_u->don_o) ) {
+      return;
+    }
+
+    c3_assert( red_u->ent_u );
+    c3_assert( red_u->ext_u );
+    pay_u.ent_u = red_u->ent_u;
+    pay_u.ext_u = red_u->ext_u;
+    red_u->ent_u = 0;
+    red_u->ext_u = 0;
+
+    _disk_read_close(red_u);
+    log_u->cb_u.read_done_f(log_u->cb_u.ptr_v, pay_u);
+  }
+}
+
+/* _disk_read_one(): decode event, enqueue in read response.
+**
+**   if the read is raw, the fact takes ownership of [dat_y] instead.
+*/
+static c3_o
+_disk_read_one(u3_read* red_u, c3_d eve_d, size_t val_i, c3_y* dat_y)
+{
+  u3_fact* tac_u;
+
+  if ( 4 >= val_i ) {
+    return c3n;
+  }
+
+  if ( c3y == red_u->raw_o ) {
+    c3_l mug_l = dat_y[0]
+               ^ (dat_y[1] <<  8)
+               ^ (dat_y[2] << 16)
+               ^ (dat_y[3] << 24);
+
+    tac_u = u3_fact_init(eve_d, mug_l, u3_none);
+    tac_u->byt_y = dat_y;
+    tac_u->siz_i = val_i;
+  }
+  else {
+    u3_noun job;
+    c3_l  mug_l = dat_y[0]
+                ^ (dat_y[1] <<  8)
+                ^ (dat_y[2] << 16)
+                ^ (dat_y[3] << 24);
+
+#ifdef DISK_TRACE_CUE
+    u3t_event_trace("king disk cue", 'B');
+#endif
+
+    //  XX u3m_soft?
+    //
+    job = u3ke_cue(u3i_bytes(val_i - 4, dat_y + 4));
+
+#ifdef DISK_TRACE_CUE
+    u3t_event_trace("king disk cue", 'E');
+#endif
+
+    tac_u = u3_fact_init(eve_d, mug_l, job);
+  }
+
+  if ( !red_u->ent_u ) {
+    c3_assert( !red_u->ext_u );
+
+    c3_assert( red_u->eve_d == eve_d );
+    red_u->ent_u = red_u->ext_u = tac_u;
+  }
+  else {
+    c3_assert( (1ULL + red_u->ent_u->eve_d) == eve_d );
+    red_u->ent_u->nex_u = tac_u;
+    red_u->ent_u = tac_u;
+  }
+
+  return c3y;
+}
+
+/* _disk_read_cue_cb(): decode a slice of raw events, yielding between slices.
+*/
+static void
+_disk_read_cue_cb(uv_idle_t* idl_u)
+{
+  u3_read* red_u = idl_u->data;
+  u3_disk* log_u = red_u->log_u;
+  c3_d     las_d = ( c3y == red_u->raw_o )
+                   ? red_u->red_d
+                   : c3_min(red_u->red_d, red_u->cur_d + DISK_CUE_SLICE);
+
+  while ( red_u->cur_d < las_d ) {
+    c3_d i_d = red_u->cur_d;
+    c3_o ret_o = _disk_read_one(red_u,
+                                red_u->eve_d + i_d,
+                                red_u->siz_i[i_d],
+                                red_u->byt_y[i_d]);
+
+    //  uncued events are owned by their facts
+    //
+    if ( (c3n == red_u->raw_o) || (c3n == ret_o) ) {
+      c3_free(red_u->byt_y[i_d]);
+    }
+
+    red_u->cur_d++;
+
+    if ( c3n == ret_o ) {
+      uv_idle_stop(idl_u);
+      log_u->cb_u.read_bail_f(log_u->cb_u.ptr_v, red_u->eve_d);
+      _disk_read_close(red_u);
+      return;
+    }
+  }
+
+  //  an active idler polls for i/o (without blocking) between slices
+  //
+  if ( red_u->cur_d < red_u->red_d ) {
+    if ( !uv_is_active((uv_handle_t*)idl_u) ) {
+      uv_idle_start(idl_u, _disk_read_cue_cb);
+    }
+  }
+  else {
+    uv_idle_stop(idl_u);
+    _disk_read_done(red_u);
+  }
+}
+
+/* _disk_read_copy_cb(): lmdb read callback, invoked for each event in order.
+**
+**   copies and decompresses events off the map.
+**   NB: runs off the main thread, must not touch the loom.
+*/
+static c3_o
+_disk_read_copy_cb(void* ptr_v, c3_d eve_d, size_t val_i, void* val_p)
+{
+  u3_read* red_u = ptr_v;
+  c3_d       i_d = red_u->red_d;
+
+  if ( (red_u->eve_d + i_d) != eve_d ) {
+    return c3n;
+  }
+
+  if ( c3n == _disk_deserialize(red_u->fir_d,
+                                red_u->dic_y,
+                                red_u->dic_i,
+                                eve_d, val_i, val_p,
+                                &red_u->siz_i[i_d],
+                                &red_u->byt_y[i_d]) )
+  {
+    return c3n;
+  }
+
+  red_u->raw_i += val_i;
+  red_u->red_d++;
+
+  return c3y;
+}
+
+/* _disk_read_cb(): off the main thread, read event-batch.
+*/
+static void
+_disk_read_cb(uv_work_t* ted_u)
+{
+  u3_read* red_u = ted_u->data;
+
+  if ( !red_u->mdb_u ) {
+    red_u->ret_o = c3n;
+    return;
+  }
+
+  //  reuse the epoch's cursor, or create one for it
+  //
+  if ( !red_u->sca_u ) {
+    red_u->sca_u = c3_malloc(sizeof(*red_u->sca_u));
+
+    if ( c3n == u3_lmdb_scan_init(red_u->mdb_u, red_u->sca_u) ) {
+      c3_free(red_u->sca_u);
+      red_u->sca_u = 0;
+      red_u->ret_o = c3n;
+      return;
+    }
+  }
+
+  red_u->ret_o = u3_lmdb_scan_read(red_u->sca_u,
+                                   red_u,
+                                   red_u->eve_d,
+                                   red_u->len_d,
+                                   _disk_read_copy_cb);
+
+  //  the next read likely follows this one, start paging it in
+  //
+  if ( c3y == red_u->ret_o ) {
+    u3_lmdb_scan_advise(red_u->sca_u,
+                        red_u->eve_d + red_u->len_d,
+                        red_u->raw_i);
+  }
+}
+
+/* _disk_read_after_cb(): on the main thread, decode event-batch.
+*/
+static void
+_disk_read_after_cb(uv_work_t* ted_u, c3_i sas_i)
+{
+  u3_read* red_u = ted_u->data;
+  u3_disk* log_u = red_u->log_u;
+
+  red_u->ted_o = c3n;
+
+  //  return the cursor to the epoch, if it has none
+  //
+  if (  red_u->sca_u
+     && (c3n == red_u->can_o)
+     && (red_u->epo_u->mdb_u == red_u->mdb_u)
+     && !red_u->epo_u->sca_u )
+  {
+    red_u->epo_u->sca_u = red_u->sca_u;
+    red_u->sca_u = 0;
+  }
+
+  if ( (c3y == red_u->can_o) || (UV_ECANCELED == sas_i) ) {
+    uv_close(&red_u->had_u, _disk_read_close_cb);
+  }
+  else if ( (c3n == red_u->ret_o) || !red_u->red_d ) {
+    log_u->cb_u.read_bail_f(log_u->cb_u.ptr_v, red_u->eve_d);
+    _disk_read_close(red_u);
+  }
+  else {
+    _disk_read_cue_cb(&red_u->idl_u);
+  }
+}
+
+/* u3_disk_read(): read up to [len_d] events starting at [eve_d],
+**                 producing the number requested.
+*/
+c3_d
+u3_disk_read(u3_disk* log_u, c3_d eve_d, c3_d len_d, c3_o raw_o)
+{
+  u3_read* red_u = c3_malloc(sizeof(*red_u));
+  u3_epoc* epo_u = _disk_epoc_find(log_u, eve_d);
+
+  //  reads are confined to a single epoch
+  //
+  if ( epo_u->nex_u && ((eve_d + len_d - 1) > epo_u->nex_u->epo_d) ) {
+    len_d = 1ULL + epo_u->nex_u->epo_d - eve_d;
+  }
+
+  _disk_epoc_idle(log_u, epo_u);
+
+  if ( epo_u->mdb_u == log_u->mdb_u ) {
+    red_u->fir_d = log_u->fom_u.fir_d;
+  }
+  else {
+    //  a failed open is reported as a failed read
+    //
+    _disk_epoc_load(log_u, epo_u);
+    red_u->fir_d = epo_u->fir_d;
+  }
+
+  red_u->log_u = log_u;
+  red_u->epo_u = epo_u;
+  red_u->mdb_u = epo_u->mdb_u;
+  red_u->sca_u = epo_u->sca_u;
+  epo_u->sca_u = 0;
+  red_u->ted_o = c3n;
+  red_u->can_o = c3n;
+  red_u->ret_o = c3n;
+  red_u->don_o = c3n;
+  red_u->raw_o = raw_o;
+  red_u->eve_d = eve_d;
+  red_u->len_d = len_d;
+  red_u->raw_i = 0;
+  red_u->cur_d = red_u->red_d = 0;
+  red_u->dic_y = log_u->fom_u.dic_y;
+  red_u->dic_i = log_u->fom_u.dic_i;
+  red_u->byt_y = c3_malloc(len_d * sizeof(c3_y*));
+  red_u->siz_i = c3_malloc(len_d * sizeof(size_t));
+  red_u->ent_u = red_u->ext_u = 0;
+  red_u->pre_u = 0;
+  red_u->nex_u = log_u->red_u;
+
+  if ( log_u->red_u ) {
+    log_u->red_u->pre_u = red_u;
+  }
+  log_u->red_u = red_u;
+
+  uv_idle_init(u3L, &red_u->idl_u);
+  red_u->idl_u.data = red_u;
+
+  //  queue asynchronous read to happen on another thread
+  //
+  red_u->ted_o = c3y;
+  red_u->ted_u.data = red_u;
+  uv_queue_work(u3L, &red_u->ted_u, _disk_read_cb,
+                                    _disk_read_after_cb);
+
+  return len_d;
+}
+
+/* _disk_save_meta(): serialize atom, save as metadata at [key_c].
+*/
+static c3_o
+_disk_save_meta(MDB_env* mdb_u, const c3_c* key_c, u3_atom dat)
+{
+  c3_w  len_w = u3r_met(3, dat);
+  c3_y* byt_y = c3_malloc(len_w);
+  u3r_bytes(0, len_w, byt_y, dat);
+
+  {
+    c3_o ret_o = u3_lmdb_save_meta(mdb_u, key_c, len_w, byt_y);
+    c3_free(byt_y);
+    return ret_o;
+  }
+}
+
+/* u3_disk_save_meta(): save metadata.
+*/
+c3_o
+u3_disk_save_meta(MDB_env* mdb_u,
+                  c3_d     who_d[2],
+                  c3_o     fak_o,
+                  c3_w     lif_w)
+{
+  c3_assert( c3y == u3a_is_cat(lif_w) );
+
+  if (  (c3n == _disk_save_meta(mdb_u, "version", DISK_VERSION))
+     || (c3n == _disk_save_meta(mdb_u, "who", u3i_chubs(2, who_d)))
+     || (c3n == _disk_save_meta(mdb_u, "fake", fak_o))
+     || (c3n == _disk_save_meta(mdb_u, "life", lif_w)) )
+  {
+    return c3n;
+  }
+
+  return c3y;
+}
+
+/* _disk_meta_read_cb(): copy [val_p] to atom [ptr_v] if present.
+*/
+static void
+_disk_meta_read_cb(void* ptr_v, size_t val_i, void* val_p)
+{
+  u3_weak* mat = ptr_v;
+
+  if ( val_p ) {
+    *mat = u3i_bytes(val_i, val_p);
+  }
+}
+
+/* _disk_read_meta(): read metadata at [key_c], deserialize.
+*/
+static u3_weak
+_disk_read_meta(MDB_env* mdb_u, const c3_c* key_c)
+{
+  u3_weak dat = u3_none;
+  u3_lmdb_read_meta(mdb_u, &dat, key_c, _disk_meta_read_cb);
+  return dat;
+}
+
+/* u3_disk_read_meta(): read metadata.
+*/
+c3_o
+u3_disk_read_meta(MDB_env* mdb_u,
+                  c3_d*    who_d,
+                  c3_o*    fak_o,
+                  c3_w*    lif_w)
+{
+  u3_weak ver, who, fak, lif;
+
+  if ( u3_none == (ver = _disk_read_meta(mdb_u, "version")) ) {
+    fprintf(stderr, "disk: read meta: no version\r\n");
+    return c3n;
+  }
+  if ( u3_none == (who = _disk_read_meta(mdb_u, "who")) ) {
+    fprintf(stderr, "disk: read meta: no indentity\r\n");
+    return c3n;
+  }
+  if ( u3_none == (fak = _disk_read_meta(mdb_u, "fake")) ) {
+    fprintf(stderr, "disk: read meta: no fake bit\r\n");
+    return c3n;
+  }
+  if ( u3_none == (lif = _disk_read_meta(mdb_u, "life")) ) {
+    fprintf(stderr, "disk: read meta: no lifecycle length\r\n");
+    return c3n;
+  }
+
+  {
+    c3_o val_o = c3y;
+
+    if ( (1 != ver) && (DISK_VERSION != ver) ) {
+      fprintf(stderr, "disk: read meta: unknown version %u\r\n", ver);
+      val_o = c3n;
+    }
+    else if ( !((c3y == fak ) || (c3n == fak )) ) {
+      fprintf(stderr, "disk: read meta: invalid fake bit\r\n");
+      val_o = c3n;
+    }
+    else if ( c3n == u3a_is_cat(lif) ) {
+      fprintf(stderr, "disk: read meta: invalid lifecycle length\r\n");
+      val_o = c3n;
+    }
+
+    if ( c3n == val_o ) {
+      u3z(ver); u3z(who); u3z(fak); u3z(lif);
+      return c3n;
+    }
+  }
+
+  if ( who_d ) {
+    u3r_chubs(0, 2, who_d, who);
+  }
+
+  if ( fak_o ) {
+    *fak_o = fak;
+  }
+
+  if ( lif_w ) {
+    *lif_w = lif;
+  }
+
+  u3z(who);
+  return c3y;
+}
+
+/* u3_disk_save_format(): save value format of [log_u] into [mdb_u],
+**                        for a log beginning at [eve_d].
+*/
+c3_o
+u3_disk_save_format(u3_disk* log_u, MDB_env* mdb_u, c3_d eve_d)
+{
+  c3_d fir_d = ( 1 == log_u->fom_u.ver_w )
+               ? (1ULL + log_u->dun_d)
+               : log_u->fom_u.fir_d;
+
+  if (  (fir_d > eve_d)
+     && (c3n == _disk_save_meta(mdb_u, "first-v2", u3i_chub(fir_d))) )
+  {
+    return c3n;
+  }
+
+  if (  log_u->fom_u.dic_y
+     && (c3n == u3_lmdb_save_meta(mdb_u, "dict",
+                                  log_u->fom_u.dic_i,
+                                  log_u->fom_u.dic_y)) )
+  {
+    return c3n;
+  }
+
+  return c3y;
+}
+
+/* _disk_dict_meta_cb(): copy dictionary [val_p] into [ptr_v] if present.
+*/
+static void
+_disk_dict_meta_cb(void* ptr_v, size_t val_i, void* val_p)
+{
+  u3_disk* log_u = ptr_v;
+
+  if ( val_p && val_i ) {
+    log_u->fom_u.dic_y = c3_malloc(val_i);
+    log_u->fom_u.dic_i = val_i;
+    memcpy(log_u->fom_u.dic_y, val_p, val_i);
+  }
+}
+
+/* _disk_read_format(): read value format version and first v2 event.
+*/
+static void
+_disk_read_format(MDB_env* mdb_u, c3_w* ver_w, c3_d* fir_d)
+{
+  u3_weak ver = _disk_read_meta(mdb_u, "version");
+
+  //  new logs are always current
+  //
+  if ( u3_none == ver ) {
+    *ver_w = DISK_VERSION;
+    *fir_d = 0;
+  }
+  else if ( 1 == ver ) {
+    *ver_w = 1;
+    *fir_d = ~0ULL;
+  }
+  else {
+    u3_weak fir = _disk_read_meta(mdb_u, "first-v2");
+
+    *ver_w = ( c3y == u3a_is_cat(ver) ) ? ver : 0;
+    *fir_d = ( u3_none == fir ) ? 0 : u3r_chub(0, fir);
+    u3z(fir);
+  }
+
+  u3z(ver);
+}
+
+/* _disk_load_format(): load value format from metadata.
+*/
+static void
+_disk_load_format(u3_disk* log_u)
+{
+  log_u->fom_u.tra_o = c3n;
+  log_u->fom_u.dic_y = 0;
+  log_u->fom_u.dic_i = 0;
+
+  _disk_read_format(log_u->mdb_u, &log_u->fom_u.ver_w, &log_u->fom_u.fir_d);
+
+  //  NB: the dictionary is shared by all epochs, see u3_disk_roll()
+  //
+  if ( 1 != log_u->fom_u.ver_w ) {
+    u3_lmdb_read_meta(log_u->mdb_u, log_u, "dict", _disk_dict_meta_cb);
+  }
+
+  log_u->fom_u.tri_d = c3_max(log_u->fom_u.fir_d, 1ULL) + DISK_DICT_EVENTS;
+}
+
+/* _disk_epoc_path(): path to epoch directory, or [nam_c] within it.
+*/
+static c3_c*
+_disk_epoc_path(u3_disk* log_u, c3_d epo_d, const c3_c* nam_c)
+{
+  c3_c* pax_c = log_u->com_u->pax_c;
+  c3_w  len_w = strlen(pax_c) + 24 + (nam_c ? 1 + strlen(nam_c) : 0);
+  c3_c* paf_c = c3_malloc(len_w);
+
+  if ( nam_c ) {
+    snprintf(paf_c, len_w, "%s/0i%" PRIu64 "/%s", pax_c, epo_d, nam_c);
+  }
+  else {
+    snprintf(paf_c, len_w, "%s/0i%" PRIu64, pax_c, epo_d);
+  }
+
+  return paf_c;
+}
+
+/* _disk_epoc_open(): open epoch environment at [pax_c].
+*/
+static MDB_env*
+_disk_epoc_open(const c3_c* pax_c)
+{
+  if ( c3_mkdir(pax_c, 0700) && (EEXIST != errno) ) {
+    fprintf(stderr, "disk: mkdir %s: %s\r\n", pax_c, strerror(errno));
+    return 0;
+  }
+
+  return u3_lmdb_init(pax_c, DISK_MAP_SIZE);
+}
+
+/* _disk_epoc_wipe(): delete epoch directory at [pax_c].
+*/
+static c3_o
+_disk_epoc_wipe(const c3_c* pax_c)
+{
+  c3_c paf_c[8193];
+
+  snprintf(paf_c, sizeof(paf_c), "%s/data.mdb", pax_c);
+
+  if ( c3_unlink(paf_c) && (ENOENT != errno) ) {
+    fprintf(stderr, "disk: unlink %s: %s\r\n", paf_c, strerror(errno));
+    return c3n;
+  }
+
+  snprintf(paf_c, sizeof(paf_c), "%s/lock.mdb", pax_c);
+
+  if ( c3_unlink(paf_c) && (ENOENT != errno) ) {
+    fprintf(stderr, "disk: unlink %s: %s\r\n", paf_c, strerror(errno));
+    return c3n;
+  }
+
+  if ( c3_rmdir(pax_c) && (ENOENT != errno) ) {
+    fprintf(stderr, "disk: rmdir %s: %s\r\n", pax_c, strerror(errno));
+    return c3n;
+  }
+
+  return c3y;
+}
+
+/* _disk_epoc_close(): close epoch environment, if open.
+*/
+static void
+_disk_epoc_close(u3_epoc* epo_u)
+{
+  if ( epo_u->sca_u ) {
+    u3_lmdb_scan_done(epo_u->sca_u);
+    c3_free(epo_u->sca_u);
+    epo_u->sca_u = 0;
+  }
+
+  if ( epo_u->mdb_u ) {
+    u3_lmdb_exit(epo_u->mdb_u);
+    epo_u->mdb_u = 0;
+  }
+}
+
+/* _disk_epoc_load(): open epoch [epo_u] for reading, if needed.
+*/
+static c3_o
+_disk_epoc_load(u3_disk* log_u, u3_epoc* epo_u)
+{
+  if ( !epo_u->mdb_u ) {
+    c3_c* pax_c = _disk_epoc_path(log_u, epo_u->epo_d, 0);
+    c3_w  ver_w;
+
+    epo_u->mdb_u = _disk_epoc_open(pax_c);
+    c3_free(pax_c);
+
+    if ( !epo_u->mdb_u ) {
+      return c3n;
+    }
+
+    _disk_read_format(epo_u->mdb_u, &ver_w, &epo_u->fir_d);
+  }
+
+  return c3y;
+}
+
+/* _disk_epoc_find(): find the epoch containing [eve_d].
+*/
+static u3_epoc*
+_disk_epoc_find(u3_disk* log_u, c3_d eve_d)
+{
+  u3_epoc* epo_u = log_u->epo_u;
+
+  while ( epo_u->nex_u && (eve_d > epo_u->nex_u->epo_d) ) {
+    epo_u = epo_u->nex_u;
+  }
+
+  return epo_u;
+}
+
+/* _disk_epoc_idle(): close past epochs before [cur_u] not being read.
+*/
+static void
+_disk_epoc_idle(u3_disk* log_u, u3_epoc* cur_u)
+{
+  u3_epoc* epo_u;
+  u3_read* red_u;
+
+  for ( epo_u = log_u->epo_u; epo_u != cur_u; epo_u = epo_u->nex_u ) {
+    if ( !epo_u->mdb_u || (epo_u->mdb_u == log_u->mdb_u) ) {
+      continue;
+    }
+
+    for ( red_u = log_u->red_u; red_u; red_u = red_u->nex_u ) {
+      if ( red_u->mdb_u == epo_u->mdb_u ) {
+        break;
+      }
+    }
+
+    if ( !red_u ) {
+      _disk_epoc_close(epo_u);
+    }
+  }
+}
+
+/* _disk_epoc_scan(): load the list of epochs, oldest first.
+*/
+static c3_o
+_disk_epoc_scan(u3_disk* log_u)
+{
+  DIR*           rid_u;
+  struct dirent* den_u;
+
+  if ( !(rid_u = c3_opendir(log_u->com_u->pax_c)) ) {
+    fprintf(stderr, "disk: opendir %s: %s\r\n",
+                    log_u->com_u->pax_c, strerror(errno));
+    return c3n;
+  }
+
+  while ( (den_u = readdir(rid_u)) ) {
+    c3_c*     end_c;
+    c3_d      epo_d;
+    u3_epoc*  epo_u;
+    u3_epoc** las_u;
+
+    if (  strncmp(den_u->d_name, "0i", 2)
+       || !isdigit(den_u->d_name[2]) )
+    {
+      continue;
+    }
+
+    errno = 0;
+    epo_d = strtoull(den_u->d_name + 2, &end_c, 10);
+
+    if ( errno || *end_c ) {
+      continue;
+    }
+
+    epo_u = c3_calloc(sizeof(*epo_u));
+    epo_u->epo_d = epo_d;
+
+    //  insert in order
+    //
+    las_u = &log_u->epo_u;
+
+    while ( *las_u && ((*las_u)->epo_d < epo_d) ) {
+      las_u = &(*las_u)->nex_u;
+    }
+
+    epo_u->nex_u = *las_u;
+    *las_u = epo_u;
+  }
+
+  closedir(rid_u);
+  return c3y;
+}
+
+/* _disk_epoc_migrate(): move a legacy, unsegmented log into an epoch.
+*/
+static c3_o
+_disk_epoc_migrate(u3_disk* log_u)
+{
+  c3_c*    log_c = log_u->com_u->pax_c;
+  c3_c     dat_c[8193], new_c[8193];
+  c3_c*    pax_c;
+  MDB_env* mdb_u;
+  c3_d     fir_d, las_d, epo_d;
+
+  snprintf(dat_c, sizeof(dat_c), "%s/data.mdb", log_c);
+
+  if ( 0 != access(dat_c, F_OK) ) {
+    return c3y;
+  }
+
+  //  the epoch begins at the first event in the log
+  //
+  if ( !(mdb_u = u3_lmdb_init(log_c, DISK_MAP_SIZE)) ) {
+    return c3n;
+  }
+
+  if ( c3n == u3_lmdb_gulf(mdb_u, &fir_d, &las_d) ) {
+    u3_lmdb_exit(mdb_u);
+    return c3n;
+  }
+
+  u3_lmdb_exit(mdb_u);
+
+  epo_d = ( fir_d ) ? fir_d - 1 : 0;
+  pax_c = _disk_epoc_path(log_u, epo_d, 0);
+
+  if ( c3_mkdir(pax_c, 0700) && (EEXIST != errno) ) {
+    fprintf(stderr, "disk: mkdir %s: %s\r\n", pax_c, strerror(errno));
+    c3_free(pax_c);
+    return c3n;
+  }
+
+  snprintf(new_c, sizeof(new_c), "%s/data.mdb", pax_c);
+
+  if ( c3_rename(dat_c, new_c) ) {
+    fprintf(stderr, "disk: rename %s: %s\r\n", dat_c, strerror(errno));
+    c3_free(pax_c);
+    return c3n;
+  }
+
+  snprintf(dat_c, sizeof(dat_c), "%s/lock.mdb", log_c);
+  c3_unlink(dat_c);
+
+  u3l_log("disk: migrated event log to epoch %s", pax_c);
+  c3_free(pax_c);
+  return c3y;
+}
+
+/* u3_disk_roll(): start a new epoch after snapshot at [eve_d].
+*/
+c3_o
+u3_disk_roll(u3_disk* log_u, c3_d eve_d)
+{
+  c3_c*    pax_c;
+  c3_c*    tmp_c;
+  MDB_env* mdb_u;
+  u3_epoc* epo_u;
+  c3_d     who_d[2];
+  c3_o     fak_o;
+  c3_w     lif_w;
+
+  //  already current
+  //
+  if ( eve_d == log_u->epo_d ) {
+    return c3y;
+  }
+
+  //  only roll a quiescent log, at its head
+  //
+  if (  (eve_d != log_u->dun_d)
+     || (log_u->sen_d != log_u->dun_d)
+     || (c3y == log_u->ted_o)
+     || (c3y == log_u->fom_u.tra_o)
+     || log_u->red_u )
+  {
+    return c3n;
+  }
+
+  if ( c3y != u3_disk_read_meta(log_u->mdb_u, who_d, &fak_o, &lif_w) ) {
+    return c3n;
+  }
+
+  //  build the epoch under a temporary name, so that a partial
+  //  epoch is never mistaken for the current one
+  //
+  {
+    c3_w len_w = strlen(log_u->com_u->pax_c) + sizeof("/tmp");
+    tmp_c = c3_malloc(len_w);
+    snprintf(tmp_c, len_w, "%s/tmp", log_u->com_u->pax_c);
+  }
+
+  _disk_epoc_wipe(tmp_c);
+
+  if ( !(mdb_u = _disk_epoc_open(tmp_c)) ) {
+    c3_free(tmp_c);
+    return c3n;
+  }
+
+  if (  (c3n == u3_disk_save_meta(mdb_u, who_d, fak_o, lif_w))
+     || (c3n == u3_disk_save_format(log_u, mdb_u, eve_d + 1)) )
+  {
+    u3_lmdb_exit(mdb_u);
+    _disk_epoc_wipe(tmp_c);
+    c3_free(tmp_c);
+    return c3n;
+  }
+
+  pax_c = _disk_epoc_path(log_u, eve_d, 0);
+
+  if ( c3_rename(tmp_c, pax_c) ) {
+    fprintf(stderr, "disk: rename %s: %s\r\n", tmp_c, strerror(errno));
+    u3_lmdb_exit(mdb_u);
+    _disk_epoc_wipe(tmp_c);
+    c3_free(tmp_c);
+    c3_free(pax_c);
+    return c3n;
+  }
+
+  c3_free(tmp_c);
+
+  //  close the previous epoch, it will only be read from now on
+  //
+  {
+    u3_epoc* las_u = _disk_epoc_find(log_u, ~0ULL);
+
+    _disk_epoc_close(las_u);
+
+    epo_u = c3_calloc(sizeof(*epo_u));
+    epo_u->epo_d = eve_d;
+    epo_u->mdb_u = mdb_u;
+    las_u->nex_u = epo_u;
+  }
+
+  log_u->mdb_u = mdb_u;
+  log_u->epo_d = eve_d;
+
+  if ( u3_lmdb_sync_full != log_u->gru_u.syn_y ) {
+    u3_lmdb_set_sync(mdb_u, log_u->gru_u.syn_y);
+  }
+
+  //  new epochs are always current, and keep the dictionary
+  //
+  log_u->fom_u.ver_w = DISK_VERSION;
+  log_u->fom_u.fir_d = 0;
+
+  if ( !log_u->fom_u.dic_y ) {
+    log_u->fom_u.tri_d = eve_d + DISK_DICT_EVENTS;
+  }
+
+  u3l_log("disk: epoch %s", pax_c);
+  c3_free(pax_c);
+
+  return c3y;
+}
+
+/* u3_disk_chop(): delete epochs ending at or before [eve_d],
+**                 but for the last of them.
+*/
+c3_o
+u3_disk_chop(u3_disk* log_u, c3_d eve_d)
+{
+  u3_epoc* epo_u;
+
+  //  the previous epoch is kept, as the only copy of its events
+  //  outside of the snapshot, until the next chop
+  //
+  while (  (epo_u = log_u->epo_u)
+        && epo_u->nex_u
+        && epo_u->nex_u->nex_u
+        && (epo_u->nex_u->nex_u->epo_d <= eve_d) )
+  {
+    c3_c* pax_c;
+    u3_read* red_u;
+
+    for ( red_u = log_u->red_u; red_u; red_u = red_u->nex_u ) {
+      if ( epo_u->mdb_u && (red_u->mdb_u == epo_u->mdb_u) ) {
+        return c3n;
+      }
     }
 
-    if ( red_u->nex_u ) {
-      red_u->nex_u->pre_u = red_u->pre_u;
-    }
-  }
+    _disk_epoc_close(epo_u);
 
-  uv_close(&red_u->had_u, _disk_read_close_cb);
-}
+    pax_c = _disk_epoc_path(log_u, epo_u->epo_d, 0);
 
-/* _disk_read_done_cb(): finalize read, invoke callback with response.
-*/
-static void
-_disk_read_done_cb(uv_timer_t* tim_u)
-{
-  u3_read* red_u = tim_u->data;
-  u3_disk* log_u = red_u->log_u;
-  u3_info  pay_u = { .ent_u = red_u->ent_u, .ext_u = red_u->ext_u };
+    if ( c3n == _disk_epoc_wipe(pax_c) ) {
+      c3_free(pax_c);
+      return c3n;
+    }
 
-  c3_assert( red_u->ent_u );
-  c3_assert( red_u->ext_u );
-  red_u->ent_u = 0;
-  red_u->ext_u = 0;
+    u3l_log("disk: deleted epoch %s", pax_c);
+    c3_free(pax_c);
 
-  log_u->cb_u.read_done_f(log_u->cb_u.ptr_v, pay_u);
-  _disk_read_close(red_u);
+    log_u->epo_u = epo_u->nex_u;
+    c3_free(epo_u);
+  }
+
+  return c3y;
 }
 
-/* _disk_read_one_cb(): lmdb read callback, invoked for each event in order
+/* _disk_index_make(): compute index entry for stored event [val_y].
+**
+**   NB: safe off the main thread.
 */
 static c3_o
-_disk_read_one_cb(void* ptr_v, c3_d eve_d, size_t val_i, void* val_p)
+_disk_index_make(c3_d        fir_d,
+                 const c3_y* dic_y,
+                 size_t      dic_i,
+                 c3_d        eve_d,
+                 size_t      val_i,
+                 const c3_y* val_y,
+                 c3_y*       idx_y)
 {
-  u3_read* red_u = ptr_v;
-  u3_disk* log_u = red_u->log_u;
-  u3_fact* tac_u;
+  size_t dat_i;
+  c3_y*  dat_y;
+  c3_l   mug_l;
 
-  if ( 4 >= val_i ) {
+  if ( c3n == _disk_deserialize(fir_d, dic_y, dic_i, eve_d,
+                                val_i, val_y, &dat_i, &dat_y) )
+  {
     return c3n;
   }
 
-  {
-    u3_noun job;
-    c3_y* dat_y = val_p;
-    c3_l  mug_l = dat_y[0]
-                ^ (dat_y[1] <<  8)
-                ^ (dat_y[2] << 16)
-                ^ (dat_y[3] << 24);
+  if ( 4 > dat_i ) {
+    c3_free(dat_y);
+    return c3n;
+  }
 
-#ifdef DISK_TRACE_CUE
-    u3t_event_trace("king disk cue", 'B');
-#endif
+  mug_l = dat_y[0]
+        ^ (dat_y[1] <<  8)
+        ^ (dat_y[2] << 16)
+        ^ (dat_y[3] << 24);
 
-    //  XX u3m_soft?
-    //
-    job = u3ke_cue(u3i_bytes(val_i - 4, dat_y + 4));
+  _disk_index_etch(idx_y, mug_l, dat_i - 4, dat_y + 4, val_i);
+  c3_free(dat_y);
 
-#ifdef DISK_TRACE_CUE
-    u3t_event_trace("king disk cue", 'E');
-#endif
+  return c3y;
+}
 
-    tac_u = u3_fact_init(eve_d, mug_l, job);
-  }
+struct _cd_look {
+  c3_o             fon_o;               //  entry found
+  c3_d             fir_d;               //  first v2 event
+  const c3_y*      dic_y;               //  deflate dictionary
+  size_t           dic_i;               //  dictionary length
+  c3_y             idx_y[DISK_INDEX_SIZE];
+};
 
-  if ( !red_u->ent_u ) {
-    c3_assert( !red_u->ext_u );
+/* _disk_look_index_cb(): copy stored index entry.
+*/
+static c3_o
+_disk_look_index_cb(void* ptr_v, c3_d eve_d, size_t val_i, void* val_p)
+{
+  struct _cd_look* lok_u = ptr_v;
 
-    c3_assert( red_u->eve_d == eve_d );
-    red_u->ent_u = red_u->ext_u = tac_u;
-  }
-  else {
-    c3_assert( (1ULL + red_u->ent_u->eve_d) == eve_d );
-    red_u->ent_u->nex_u = tac_u;
-    red_u->ent_u = tac_u;
+  if ( DISK_INDEX_SIZE == val_i ) {
+    memcpy(lok_u->idx_y, val_p, DISK_INDEX_SIZE);
+    lok_u->fon_o = c3y;
   }
 
   return c3y;
 }
 
-/* _disk_read_start_cb(): the read from the db, trigger response
+/* _disk_look_event_cb(): compute index entry from event.
 */
-static void
-_disk_read_start_cb(uv_timer_t* tim_u)
+static c3_o
+_disk_look_event_cb(void* ptr_v, c3_d eve_d, size_t val_i, void* val_p)
 {
-  u3_read* red_u = tim_u->data;
-  u3_disk* log_u = red_u->log_u;
+  struct _cd_look* lok_u = ptr_v;
 
-  //  read events synchronously
-  //
-  if ( c3n == u3_lmdb_read(log_u->mdb_u,
-                           red_u,
-                           red_u->eve_d,
-                           red_u->len_d,
-                           _disk_read_one_cb) )
-  {
-    log_u->cb_u.read_bail_f(log_u->cb_u.ptr_v, red_u->eve_d);
-    _disk_read_close(red_u);
-  }
-  //  finish the read asynchronously
-  //
-  else {
-    uv_timer_start(&red_u->tim_u, _disk_read_done_cb, 0, 0);
-  }
+  lok_u->fon_o = _disk_index_make(lok_u->fir_d, lok_u->dic_y, lok_u->dic_i,
+                                  eve_d, val_i, val_p, lok_u->idx_y);
+  return lok_u->fon_o;
 }
 
-/* u3_disk_read(): read [len_d] events starting at [eve_d].
+/* u3_disk_index(): look up the mug and sizes of event [eve_d],
+**                  from the index if present, without decoding it.
 */
-void
-u3_disk_read(u3_disk* log_u, c3_d eve_d, c3_d len_d)
+c3_o
+u3_disk_index(u3_disk* log_u,
+              c3_d     eve_d,
+              c3_l*    mug_l,
+              c3_d*    len_d,
+              c3_d*    siz_d,
+              c3_o*    dex_o)
 {
-  u3_read* red_u = c3_malloc(sizeof(*red_u));
-  red_u->log_u = log_u;
-  red_u->eve_d = eve_d;
-  red_u->len_d = len_d;
-  red_u->ent_u = red_u->ext_u = 0;
-  red_u->pre_u = 0;
-  red_u->nex_u = log_u->red_u;
+  struct _cd_look lok_u = { .fon_o = c3n };
+  u3_epoc*        epo_u;
+  c3_w            crc_w;
 
-  if ( log_u->red_u ) {
-    log_u->red_u->pre_u = red_u;
+  if ( !eve_d || (eve_d > log_u->dun_d) ) {
+    return c3n;
   }
-  log_u->red_u = red_u;
 
-  //  perform the read asynchronously
+  epo_u = _disk_epoc_find(log_u, eve_d);
+
+  if ( c3n == _disk_epoc_load(log_u, epo_u) ) {
+    return c3n;
+  }
+
+  lok_u.fir_d = ( epo_u->mdb_u == log_u->mdb_u )
+                ? log_u->fom_u.fir_d
+                : epo_u->fir_d;
+  lok_u.dic_y = log_u->fom_u.dic_y;
+  lok_u.dic_i = log_u->fom_u.dic_i;
+
+  u3_lmdb_read_index(epo_u->mdb_u, &lok_u, eve_d, 1, _disk_look_index_cb);
+  *dex_o = lok_u.fon_o;
+
+  //  unindexed events are measured, but still not cued
   //
-  uv_timer_init(u3L, &red_u->tim_u);
+  if (  (c3n == lok_u.fon_o)
+     && (  (c3n == u3_lmdb_read(epo_u->mdb_u, &lok_u, eve_d, 1,
+                                _disk_look_event_cb))
+        || (c3n == lok_u.fon_o) ) )
+  {
+    return c3n;
+  }
+
+  _disk_index_sift(lok_u.idx_y, mug_l, &crc_w, len_d, siz_d);
 
-  red_u->tim_u.data = red_u;
-  uv_timer_start(&red_u->tim_u, _disk_read_start_cb, 0, 0);
+  return c3y;
 }
 
-/* _disk_save_meta(): serialize atom, save as metadata at [key_c].
+/* _disk_scan_index_cb(): stash stored index entry.
 */
 static c3_o
-_disk_save_meta(MDB_env* mdb_u, const c3_c* key_c, u3_atom dat)
+_disk_scan_index_cb(void* ptr_v, c3_d eve_d, size_t val_i, void* val_p)
 {
-  c3_w  len_w = u3r_met(3, dat);
-  c3_y* byt_y = c3_malloc(len_w);
-  u3r_bytes(0, len_w, byt_y, dat);
+  struct _cd_chunk* chu_u = ptr_v;
+  c3_d              i_d   = eve_d - chu_u->eve_d;
 
-  {
-    c3_o ret_o = u3_lmdb_save_meta(mdb_u, key_c, len_w, byt_y);
-    c3_free(byt_y);
-    return ret_o;
+  if ( DISK_INDEX_SIZE != val_i ) {
+    chu_u->has_y[i_d] = 2;
+  }
+  else {
+    memcpy(chu_u->idx_y + (i_d * DISK_INDEX_SIZE), val_p, DISK_INDEX_SIZE);
+    chu_u->has_y[i_d] = 1;
   }
+
+  return c3y;
 }
 
-/* u3_disk_save_meta(): save metadata.
+/* _disk_scan_event_cb(): verify event against its index entry.
 */
-c3_o
-u3_disk_save_meta(MDB_env* mdb_u,
-                  c3_d     who_d[2],
-                  c3_o     fak_o,
-                  c3_w     lif_w)
+static c3_o
+_disk_scan_event_cb(void* ptr_v, c3_d eve_d, size_t val_i, void* val_p)
 {
-  c3_assert( c3y == u3a_is_cat(lif_w) );
+  struct _cd_chunk* chu_u = ptr_v;
+  struct _cd_scan*  sca_u = chu_u->sca_u;
+  c3_d              i_d   = eve_d - chu_u->eve_d;
+  c3_y*             idx_y = chu_u->idx_y + (i_d * DISK_INDEX_SIZE);
+  c3_y              new_y[DISK_INDEX_SIZE];
 
-  if (  (c3n == _disk_save_meta(mdb_u, "version", 1))
-     || (c3n == _disk_save_meta(mdb_u, "who", u3i_chubs(2, who_d)))
-     || (c3n == _disk_save_meta(mdb_u, "fake", fak_o))
-     || (c3n == _disk_save_meta(mdb_u, "life", lif_w)) )
+  chu_u->red_d++;
+
+  if ( c3n == _disk_index_make(chu_u->fir_d, sca_u->dic_y, sca_u->dic_i,
+                               eve_d, val_i, val_p, new_y) )
   {
-    return c3n;
+    fprintf(stderr, "disk: scan: (%" PRIu64 "): undecodable\r\n", eve_d);
+    chu_u->bad_d++;
+    return c3y;
+  }
+
+  switch ( chu_u->has_y[i_d] ) {
+    default: c3_assert(0);
+
+    case 0: {
+      memcpy(idx_y, new_y, DISK_INDEX_SIZE);
+      chu_u->mis_d++;
+    } break;
+
+    case 1: {
+      if ( memcmp(idx_y, new_y, DISK_INDEX_SIZE) ) {
+        c3_l mug_l, gum_l;
+        c3_w crc_w, rcc_w;
+        c3_d len_d, nel_d, siz_d, zis_d;
+
+        _disk_index_sift(idx_y, &mug_l, &crc_w, &len_d, &siz_d);
+        _disk_index_sift(new_y, &gum_l, &rcc_w, &nel_d, &zis_d);
+
+        fprintf(stderr, "disk: scan: (%" PRIu64 "): mismatch: "
+                        "mug %x/%x crc %x/%x len %" PRIu64 "/%" PRIu64
+                        " size %" PRIu64 "/%" PRIu64 "\r\n",
+                        eve_d, mug_l, gum_l, crc_w, rcc_w,
+                        len_d, nel_d, siz_d, zis_d);
+        chu_u->bad_d++;
+      }
+    } break;
+
+    case 2: {
+      fprintf(stderr, "disk: scan: (%" PRIu64 "): invalid index entry\r\n",
+                      eve_d);
+      chu_u->bad_d++;
+    } break;
   }
 
   return c3y;
 }
 
-/* _disk_meta_read_cb(): copy [val_p] to atom [ptr_v] if present.
+/* _disk_scan_next(): claim the next chunk of work, if any.
 */
-static void
-_disk_meta_read_cb(void* ptr_v, size_t val_i, void* val_p)
+static MDB_env*
+_disk_scan_next(struct _cd_chunk* chu_u)
 {
-  u3_weak* mat = ptr_v;
+  struct _cd_scan* sca_u = chu_u->sca_u;
+  MDB_env*         mdb_u = 0;
 
-  if ( val_p ) {
-    *mat = u3i_bytes(val_i, val_p);
+  uv_mutex_lock(&sca_u->mut_u);
+
+  if ( sca_u->cur_w < sca_u->len_w ) {
+    struct _cd_span* spa_u = &sca_u->spa_u[sca_u->cur_w];
+
+    mdb_u        = spa_u->mdb_u;
+    chu_u->fir_d = spa_u->fir_d;
+    chu_u->eve_d = sca_u->nex_d;
+    chu_u->len_d = c3_min(DISK_SCAN_BATCH, 1ULL + spa_u->las_d - sca_u->nex_d);
+
+    sca_u->nex_d += chu_u->len_d;
+
+    if ( sca_u->nex_d > spa_u->las_d ) {
+      if ( ++sca_u->cur_w < sca_u->len_w ) {
+        sca_u->nex_d = sca_u->spa_u[sca_u->cur_w].eve_d;
+      }
+    }
   }
+
+  uv_mutex_unlock(&sca_u->mut_u);
+
+  return mdb_u;
 }
 
-/* _disk_read_meta(): read metadata at [key_c], deserialize.
+/* _disk_scan_cb(): verify chunks of the event log until none remain.
 */
-static u3_weak
-_disk_read_meta(MDB_env* mdb_u, const c3_c* key_c)
+static void
+_disk_scan_cb(void* ptr_v)
 {
-  u3_weak dat = u3_none;
-  u3_lmdb_read_meta(mdb_u, &dat, key_c, _disk_meta_read_cb);
-  return dat;
+  struct _cd_chunk chu_u = { .sca_u = ptr_v };
+  struct _cd_scan* sca_u = chu_u.sca_u;
+  MDB_env*         mdb_u;
+
+  chu_u.idx_y = c3_malloc(DISK_SCAN_BATCH * DISK_INDEX_SIZE);
+  chu_u.has_y = c3_malloc(DISK_SCAN_BATCH);
+
+  while ( (mdb_u = _disk_scan_next(&chu_u)) ) {
+    c3_o ret_o;
+    c3_d fix_d = 0;
+
+    memset(chu_u.has_y, 0, chu_u.len_d);
+    chu_u.red_d = chu_u.mis_d = chu_u.bad_d = 0;
+
+    ret_o = u3_lmdb_read_index(mdb_u, &chu_u, chu_u.eve_d, chu_u.len_d,
+                               _disk_scan_index_cb);
+
+    if ( c3y == ret_o ) {
+      ret_o = u3_lmdb_read(mdb_u, &chu_u, chu_u.eve_d, chu_u.len_d,
+                           _disk_scan_event_cb);
+    }
+
+    if ( (c3y == ret_o) && (chu_u.red_d != chu_u.len_d) ) {
+      fprintf(stderr, "disk: scan: (%" PRIu64 "): missing events\r\n",
+                      chu_u.eve_d + chu_u.red_d);
+      ret_o = c3n;
+    }
+
+    if ( c3n == ret_o ) {
+      fprintf(stderr, "disk: scan: (%" PRIu64 "-%" PRIu64 "): read failed\r\n",
+                      chu_u.eve_d,
+                      chu_u.eve_d + (chu_u.len_d - 1ULL));
+    }
+
+    //  only backfill an index that is otherwise consistent
+    //
+    if (  (c3y == sca_u->fix_o)
+       && (c3y == ret_o)
+       && chu_u.mis_d
+       && !chu_u.bad_d
+       && (c3y == u3_lmdb_save_index(mdb_u, chu_u.eve_d, chu_u.len_d,
+                                     chu_u.idx_y, DISK_INDEX_SIZE)) )
+    {
+      fix_d = chu_u.mis_d;
+    }
+
+    uv_mutex_lock(&sca_u->mut_u);
+    sca_u->ret_o  = c3a(sca_u->ret_o, ret_o);
+    sca_u->red_d += chu_u.red_d;
+    sca_u->mis_d += chu_u.mis_d;
+    sca_u->bad_d += chu_u.bad_d;
+    sca_u->fix_d += fix_d;
+    uv_mutex_unlock(&sca_u->mut_u);
+  }
+
+  c3_free(chu_u.idx_y);
+  c3_free(chu_u.has_y);
 }
 
-/* u3_disk_read_meta(): read metadata.
+/* u3_disk_scan(): verify events [eve_d, las_d] against the index,
+**                 across [thr_w] threads, optionally indexing the
+**                 unindexed.
 */
 c3_o
-u3_disk_read_meta(MDB_env* mdb_u,
-                  c3_d*    who_d,
-                  c3_o*    fak_o,
-                  c3_w*    lif_w)
+u3_disk_scan(u3_disk* log_u, c3_d eve_d, c3_d las_d, c3_w thr_w, c3_o fix_o)
 {
-  u3_weak ver, who, fak, lif;
+  struct _cd_scan sca_u = {0};
+  uv_thread_t*    tid_u;
+  u3_epoc*        epo_u;
+  c3_d            len_d = 0;
+  c3_d            tim_d = uv_hrtime();
+  c3_w            i_w;
 
-  if ( u3_none == (ver = _disk_read_meta(mdb_u, "version")) ) {
-    fprintf(stderr, "disk: read meta: no version\r\n");
-    return c3n;
-  }
-  if ( u3_none == (who = _disk_read_meta(mdb_u, "who")) ) {
-    fprintf(stderr, "disk: read meta: no indentity\r\n");
-    return c3n;
-  }
-  if ( u3_none == (fak = _disk_read_meta(mdb_u, "fake")) ) {
-    fprintf(stderr, "disk: read meta: no fake bit\r\n");
-    return c3n;
-  }
-  if ( u3_none == (lif = _disk_read_meta(mdb_u, "life")) ) {
-    fprintf(stderr, "disk: read meta: no lifecycle length\r\n");
-    return c3n;
-  }
+  eve_d = c3_max(1ULL, eve_d);
+  las_d = c3_min(las_d, log_u->dun_d);
 
-  {
-    c3_o val_o = c3y;
+  //  collect the events to verify in each epoch
+  //
+  for ( epo_u = log_u->epo_u; epo_u; epo_u = epo_u->nex_u ) {
+    c3_d fir_d = c3_max(eve_d, 1ULL + epo_u->epo_d);
+    c3_d end_d = ( epo_u->nex_u ) ? epo_u->nex_u->epo_d : log_u->dun_d;
 
-    if ( 1 != ver ) {
-      fprintf(stderr, "disk: read meta: unknown version %u\r\n", ver);
-      val_o = c3n;
-    }
-    else if ( !((c3y == fak ) || (c3n == fak )) ) {
-      fprintf(stderr, "disk: read meta: invalid fake bit\r\n");
-      val_o = c3n;
-    }
-    else if ( c3n == u3a_is_cat(lif) ) {
-      fprintf(stderr, "disk: read meta: invalid lifecycle length\r\n");
-      val_o = c3n;
+    end_d = c3_min(end_d, las_d);
+
+    if ( fir_d > end_d ) {
+      continue;
     }
 
-    if ( c3n == val_o ) {
-      u3z(ver); u3z(who); u3z(fak); u3z(lif);
+    if ( c3n == _disk_epoc_load(log_u, epo_u) ) {
+      fprintf(stderr, "disk: scan: failed to open epoch 0i%" PRIu64 "\r\n",
+                      epo_u->epo_d);
+      c3_free(sca_u.spa_u);
       return c3n;
     }
+
+    sca_u.spa_u = c3_realloc(sca_u.spa_u,
+                             (1 + sca_u.len_w) * sizeof(*sca_u.spa_u));
+    sca_u.spa_u[sca_u.len_w].mdb_u = epo_u->mdb_u;
+    sca_u.spa_u[sca_u.len_w].fir_d = ( epo_u->mdb_u == log_u->mdb_u )
+                                     ? log_u->fom_u.fir_d
+                                     : epo_u->fir_d;
+    sca_u.spa_u[sca_u.len_w].eve_d = fir_d;
+    sca_u.spa_u[sca_u.len_w].las_d = end_d;
+    sca_u.len_w++;
+
+    len_d += 1ULL + end_d - fir_d;
   }
 
-  if ( who_d ) {
-    u3r_chubs(0, 2, who_d, who);
+  if ( !sca_u.len_w ) {
+    fprintf(stderr, "disk: scan: no events in range\r\n");
+    return c3y;
   }
 
-  if ( fak_o ) {
-    *fak_o = fak;
+  sca_u.nex_d = sca_u.spa_u[0].eve_d;
+  sca_u.dic_y = log_u->fom_u.dic_y;
+  sca_u.dic_i = log_u->fom_u.dic_i;
+  sca_u.fix_o = fix_o;
+  sca_u.ret_o = c3y;
+
+  //  no more threads than units of work
+  //
+  if ( !thr_w ) {
+    thr_w = uv_available_parallelism();
   }
 
-  if ( lif_w ) {
-    *lif_w = lif;
+  thr_w = (c3_w)c3_min((c3_d)thr_w,
+                       sca_u.len_w + (len_d / DISK_SCAN_BATCH));
+
+  fprintf(stderr, "disk: scan: %" PRIu64 " events in %u epochs, %u threads\r\n",
+                  len_d, sca_u.len_w, thr_w);
+
+  uv_mutex_init(&sca_u.mut_u);
+  tid_u = c3_malloc(thr_w * sizeof(*tid_u));
+
+  for ( i_w = 0; i_w < thr_w; i_w++ ) {
+    uv_thread_create(&tid_u[i_w], _disk_scan_cb, &sca_u);
   }
 
-  u3z(who);
-  return c3y;
+  for ( i_w = 0; i_w < thr_w; i_w++ ) {
+    uv_thread_join(&tid_u[i_w]);
+  }
+
+  uv_mutex_destroy(&sca_u.mut_u);
+  c3_free(tid_u);
+  c3_free(sca_u.spa_u);
+
+  fprintf(stderr, "disk: scan: %" PRIu64 " verified, %" PRIu64 " mismatched, "
+                  "%" PRIu64 " unindexed, %" PRIu64 " indexed "
+                  "(%" PRIu64 "ms)\r\n",
+                  sca_u.red_d - (sca_u.mis_d + sca_u.bad_d),
+                  sca_u.bad_d,
+                  sca_u.mis_d,
+                  sca_u.fix_d,
+                  (uv_hrtime() - tim_d) / 1000000ULL);
+
+  return c3a(sca_u.ret_o, __(!sca_u.bad_d));
 }
 
 /* _disk_lock(): lockfile path.
@@ -687,29 +2626,62 @@ void
 u3_disk_exit(u3_disk* log_u)
 {
   //  cancel all outstanding reads
+  //  shortcircuit cleanup if a read thread cannot be cancelled
   //
   {
     u3_read* red_u = log_u->red_u;
+    u3_read* nex_u;
+    c3_o     ted_o = c3n;
 
     while ( red_u ) {
-      _disk_read_close(red_u);
-      red_u = red_u->nex_u;
+      nex_u = red_u->nex_u;
+
+      if ( c3n == _disk_read_close(red_u) ) {
+        ted_o = c3y;
+      }
+
+      red_u = nex_u;
+    }
+
+    if ( c3y == ted_o ) {
+      return;
     }
   }
 
   //  try to cancel write thread
-  //  shortcircuit cleanup if we cannot
+  //  shortcircuit cleanup if we cannot (or if still serializing)
   //
   if (  (c3y == log_u->ted_o)
-     && (0 > uv_cancel(&log_u->req_u)) )
+     && (  ((struct _cd_save*)log_u->ted_u.data)->pen_w
+        || (0 > uv_cancel(&log_u->req_u)) ) )
   {
     // u3l_log("disk: unable to cleanup");
     return;
   }
 
-  //  close database
+  //  shortcircuit cleanup if training a dictionary
+  //
+  if ( c3y == log_u->fom_u.tra_o ) {
+    return;
+  }
+
+  uv_close((uv_handle_t*)log_u->gru_u.tim_u, (uv_close_cb)free);
+
+  //  close databases
   //
-  u3_lmdb_exit(log_u->mdb_u);
+  {
+    u3_epoc* epo_u = log_u->epo_u;
+    u3_epoc* nex_u;
+
+    while ( epo_u ) {
+      nex_u = epo_u->nex_u;
+      _disk_epoc_close(epo_u);
+      c3_free(epo_u);
+      epo_u = nex_u;
+    }
+  }
+
+  c3_free(log_u->fom_u.dic_y);
 
   //  dispose planned writes
   //
@@ -785,6 +2757,38 @@ u3_disk_slog(u3_disk* log_u)
           ( c3y == log_u->liv_o ) ? "&" : "|",
           log_u->dun_d);
 
+  u3l_log("    format: v%u%s",
+          log_u->fom_u.ver_w,
+          ( log_u->fom_u.dic_y ) ? ", deflate" : "");
+
+  {
+    static const c3_c* syn_c[] = { "full", "meta", "none" };
+    c3_d bat_d = c3_max(log_u->gru_u.bat_d, 1ULL);
+
+    u3l_log("    commit: %" PRIu64 " batches, %" PRIu64 " events"
+            " (avg %" PRIu64 ", max %" PRIu64 ")",
+            log_u->gru_u.bat_d, log_u->gru_u.eve_d,
+            log_u->gru_u.eve_d / bat_d, log_u->gru_u.big_d);
+    u3l_log("    commit queue: %" PRIu64 " (max %" PRIu64 ")",
+            log_u->sen_d - log_u->dun_d, log_u->gru_u.dep_d);
+    u3l_log("    commit save: avg %" PRIu64 "us, max %" PRIu64 "us,"
+            " sync=%s, delay=%ums, events=%" PRIu64,
+            log_u->gru_u.syn_d / bat_d, log_u->gru_u.sym_d,
+            syn_c[log_u->gru_u.syn_y],
+            log_u->gru_u.del_w, log_u->gru_u.max_d);
+  }
+
+  {
+    u3_epoc* epo_u = log_u->epo_u;
+
+    while ( epo_u ) {
+      u3l_log("    epoch: 0i%" PRIu64 "%s",
+              epo_u->epo_d,
+              ( epo_u->mdb_u == log_u->mdb_u ) ? " (current)" : "");
+      epo_u = epo_u->nex_u;
+    }
+  }
+
   {
     u3_read* red_u = log_u->red_u;
 
@@ -882,26 +2886,50 @@ u3_disk_init(c3_c* pax_c, u3_disk_cb cb_u)
       return 0;
     }
 
-    //  Arbitrarily choosing 1TB as a "large enough" mapsize
+    //  load epochs, migrating an unsegmented log
     //
-    //  per the LMDB docs:
-    //  "[..] on 64-bit there is no penalty for making this huge (say 1TB)."
+    if (  (c3n == _disk_epoc_migrate(log_u))
+       || (c3n == _disk_epoc_scan(log_u)) )
+    {
+      fprintf(stderr, "disk: failed to load epochs\r\n");
+      c3_free(log_c);
+      c3_free(log_u);
+      return 0;
+    }
+
+    if ( !log_u->epo_u ) {
+      log_u->epo_u = c3_calloc(sizeof(u3_epoc));
+    }
+
+    //  open the current epoch for writing
     //
     {
-      const size_t siz_i =
-      // 500 GiB is as large as musl on aarch64 wants to allow
-      #if (defined(U3_CPU_aarch64) && defined(U3_OS_linux))
-        0x7d00000000;
-      #else
-        0x10000000000;
-      #endif
-
-      if ( 0 == (log_u->mdb_u = u3_lmdb_init(log_c, siz_i)) ) {
+      u3_epoc* epo_u = _disk_epoc_find(log_u, ~0ULL);
+      c3_c*    pax_c = _disk_epoc_path(log_u, epo_u->epo_d, 0);
+
+      if ( 0 == (epo_u->mdb_u = _disk_epoc_open(pax_c)) ) {
         fprintf(stderr, "disk: failed to initialize database\r\n");
+        c3_free(pax_c);
         c3_free(log_c);
         c3_free(log_u);
         return 0;
       }
+
+      log_u->mdb_u = epo_u->mdb_u;
+      log_u->epo_d = epo_u->epo_d;
+      c3_free(pax_c);
+    }
+
+    //  configure group commit
+    //
+    log_u->gru_u.del_w = u3_Host.ops_u.cod_w;
+    log_u->gru_u.max_d = u3_Host.ops_u.coe_w;
+    log_u->gru_u.syn_y = c3_min(u3_Host.ops_u.syn_y, u3_lmdb_sync_none);
+    log_u->gru_u.due_o = c3n;
+
+    if ( u3_lmdb_sync_full != log_u->gru_u.syn_y ) {
+      u3l_log("disk: warning: commits are not synced (--commit-sync)");
+      u3_lmdb_set_sync(log_u->mdb_u, log_u->gru_u.syn_y);
     }
 
     c3_free(log_c);
@@ -919,9 +2947,21 @@ u3_disk_init(c3_c* pax_c, u3_disk_cb cb_u)
       return 0;
     }
 
+    //  an empty epoch follows its snapshot
+    //
+    if ( !log_u->dun_d ) {
+      log_u->dun_d = log_u->epo_d;
+    }
+
     log_u->sen_d = log_u->dun_d;
   }
 
+  _disk_load_format(log_u);
+
+  log_u->gru_u.tim_u = c3_malloc(sizeof(uv_timer_t));
+  uv_timer_init(u3L, log_u->gru_u.tim_u);
+  log_u->gru_u.tim_u->data = log_u;
+
   log_u->liv_o = c3y;
 
 #if defined(DISK_TRACE_JAM) || defined(DISK_TRACE_CUE)
@@ -5,9 +5,17 @@
 #include "noun.h"
 #include "ur.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+
 #undef LORD_TRACE_JAM
 #undef LORD_TRACE_CUE
 
+/* LORD_RING_SIZE: replay ring size, reserved up front; well under the
+**                 64MB /dev/shm of a default container.
+*/
+#define LORD_RING_SIZE (1ULL << 25)
+
 /*
 |%
 ::  +writ: from king to serf
@@ -22,13 +30,14 @@
       ==  ==
       [%peek mil=@ sam=*]  :: gang (each path $%([%once @tas @tas path] [%beam @tas beam]))
       [%play eve=@ lit=(list ?((pair @da ovum) *))]
+      [%play eve=@ %ring nam=@t off=@ud len=@ud cnt=@ud]  ::  [len=@ jam]s
       [%work mil=@ job=(pair @da ovum)]
   ==
 ::  +plea: from serf to king
 ::
 +$  plea
   $%  [%live ~]
-      [%ripe [pro=%1 hon=@ nok=@] eve=@ mug=@]
+      [%ripe [pro=%1 hon=@ nok=@] eve=@ mug=@ rin=?]  ::  ring mapped?
       [%slog pri=@ tank]
       [%flog cord]
       $:  %peek
@@ -48,6 +57,26 @@
 --
 */
 
+/* _lord_ring_done(): unmap and release the replay ring, if any.
+*/
+static void
+_lord_ring_done(u3_lord* god_u)
+{
+  u3_ring* rin_u = &god_u->rin_u;
+
+  if ( rin_u->buf_y ) {
+    munmap(rin_u->buf_y, rin_u->siz_d);
+
+    if ( c3y == rin_u->lin_o ) {
+      shm_unlink(rin_u->nam_c);
+    }
+  }
+
+  c3_free(rin_u->nam_c);
+  memset(rin_u, 0, sizeof(*rin_u));
+  rin_u->lin_o = c3n;
+}
+
 /* _lord_stop_cb(): finally all done.
 */
 static void
@@ -61,6 +90,8 @@ _lord_stop_cb(void*       ptr_v,
   void* exit_v = god_u->cb_u.ptr_v;
 
   u3s_cue_xeno_done(god_u->sil_u);
+
+  _lord_ring_done(god_u);
   c3_free(god_u);
 
   if ( exit_f ) {
@@ -103,6 +134,7 @@ _lord_writ_free(u3_writ* wit_u)
     case u3_writ_cram:
     case u3_writ_meld:
     case u3_writ_pack:
+    case u3_writ_tidy:
     case u3_writ_exit: {
     } break;
   }
@@ -201,7 +233,191 @@ _lord_writ_str(u3_writ_type typ_e)
     case u3_writ_meld: return "meld";
     case u3_writ_pack: return "pack";
     case u3_writ_exit: return "exit";
+    case u3_writ_tidy: return "tidy";
+  }
+}
+
+/* _lord_ring_free(): release the ring space of a completed writ.
+*/
+static void
+_lord_ring_free(u3_lord* god_u, u3_writ* wit_u)
+{
+  u3_ring* rin_u = &god_u->rin_u;
+  u3_writ* nex_u;
+
+  if ( c3n == wit_u->rin_o ) {
+    return;
+  }
+
+  c3_assert( rin_u->out_w );
+  rin_u->out_w--;
+
+  //  the serf has the ring mapped once it answers, so it needs no name
+  //
+  if ( c3y == rin_u->lin_o ) {
+    shm_unlink(rin_u->nam_c);
+    rin_u->lin_o = c3n;
+  }
+
+  //  batches are released in order, so the next is now the oldest
+  //
+  for ( nex_u = god_u->ext_u; nex_u; nex_u = nex_u->nex_u ) {
+    if ( c3y == nex_u->rin_o ) {
+      break;
+    }
+  }
+
+  if ( !nex_u ) {
+    c3_assert( !rin_u->out_w );
+    rin_u->hed_d = rin_u->tal_d = 0;
+  }
+  else {
+    rin_u->tal_d = nex_u->rin_d;
+  }
+}
+
+/* _lord_ring_alloc(): allocate [len_d] contiguous bytes in the ring.
+*/
+static c3_o
+_lord_ring_alloc(u3_ring* rin_u, c3_d len_d, c3_d* off_d)
+{
+  if ( !rin_u->out_w ) {
+    if ( len_d > rin_u->siz_d ) {
+      return c3n;
+    }
+
+    *off_d = 0;
+  }
+  else if ( rin_u->hed_d > rin_u->tal_d ) {
+    if ( len_d <= (rin_u->siz_d - rin_u->hed_d) ) {
+      *off_d = rin_u->hed_d;
+    }
+    else if ( len_d <= rin_u->tal_d ) {
+      *off_d = 0;
+    }
+    else {
+      return c3n;
+    }
+  }
+  else if ( len_d <= (rin_u->tal_d - rin_u->hed_d) ) {
+    *off_d = rin_u->hed_d;
+  }
+  else {
+    return c3n;
+  }
+
+  rin_u->hed_d = *off_d + len_d;
+  rin_u->out_w++;
+
+  return c3y;
+}
+
+/* _lord_ring_play(): copy an uncued replay batch into the ring,
+**                    producing a reference to it.
+*/
+static u3_weak
+_lord_ring_play(u3_lord* god_u, u3_writ* wit_u)
+{
+  u3_ring* rin_u = &god_u->rin_u;
+  u3_fact* tac_u;
+  c3_d     len_d = 0;
+  c3_d     cnt_d = 0;
+  c3_d     off_d;
+  c3_y*    buf_y;
+
+  if ( !rin_u->buf_y ) {
+    return u3_none;
   }
+
+  for ( tac_u = wit_u->fon_u.ext_u; tac_u; tac_u = tac_u->nex_u ) {
+    if ( !tac_u->byt_y ) {
+      return u3_none;
+    }
+
+    len_d += 8 + (tac_u->siz_i - 4);
+    cnt_d++;
+  }
+
+  if ( c3n == _lord_ring_alloc(rin_u, len_d, &off_d) ) {
+    return u3_none;
+  }
+
+  buf_y = rin_u->buf_y + off_d;
+
+  for ( tac_u = wit_u->fon_u.ext_u; tac_u; tac_u = tac_u->nex_u ) {
+    c3_d jam_d = tac_u->siz_i - 4;
+    c3_w i_w;
+
+    for ( i_w = 0; i_w < 8; i_w++ ) {
+      buf_y[i_w] = (jam_d >> (8 * i_w)) & 0xff;
+    }
+
+    memcpy(buf_y + 8, tac_u->byt_y + 4, jam_d);
+    buf_y += 8 + jam_d;
+  }
+
+  wit_u->rin_o = c3y;
+  wit_u->rin_d = off_d;
+
+  return u3nq(c3__ring,
+              u3i_string(rin_u->nam_c),
+              u3i_chub(off_d),
+              u3nc(u3i_chub(len_d), u3i_chub(cnt_d)));
+}
+
+/* _lord_ring_init(): create and map the replay ring, if possible.
+*/
+static void
+_lord_ring_init(u3_lord* god_u)
+{
+  static c3_w num_w = 0;
+  u3_ring*    rin_u = &god_u->rin_u;
+  c3_c        nam_c[32];
+  c3_i        fid_i;
+  void*       buf_v;
+#if defined(U3_OS_linux)
+  c3_i        ret_i;
+#endif
+
+  snprintf(nam_c, sizeof(nam_c), "/urbit-%d-%u", (c3_i)getpid(), num_w++);
+
+  if ( -1 == (fid_i = shm_open(nam_c, O_RDWR | O_CREAT | O_EXCL, 0600)) ) {
+    fprintf(stderr, "lord: ring: shm_open: %s\r\n", strerror(errno));
+    return;
+  }
+
+  //  reserve the whole ring now, as a sparse one would fault (SIGBUS)
+  //  once /dev/shm fills; without it, replay goes through the pipe.
+  //
+#if defined(U3_OS_linux)
+  if ( (ret_i = posix_fallocate(fid_i, 0, LORD_RING_SIZE)) ) {
+    fprintf(stderr, "lord: ring: fallocate: %s\r\n", strerror(ret_i));
+#else
+  if ( ftruncate(fid_i, LORD_RING_SIZE) ) {
+    fprintf(stderr, "lord: ring: ftruncate: %s\r\n", strerror(errno));
+#endif
+    close(fid_i);
+    shm_unlink(nam_c);
+    return;
+  }
+
+  buf_v = mmap(0, LORD_RING_SIZE, PROT_READ | PROT_WRITE,
+                                  MAP_SHARED, fid_i, 0);
+  close(fid_i);
+
+  if ( MAP_FAILED == buf_v ) {
+    fprintf(stderr, "lord: ring: mmap: %s\r\n", strerror(errno));
+    shm_unlink(nam_c);
+    return;
+  }
+
+  rin_u->nam_c = c3_malloc(1 + strlen(nam_c));
+  strcpy(rin_u->nam_c, nam_c);
+  rin_u->lin_o = c3y;
+  rin_u->buf_y = buf_v;
+  rin_u->siz_d = LORD_RING_SIZE;
+  rin_u->hed_d = rin_u->tal_d = 0;
+  rin_u->out_w = 0;
 }
 
 /* _lord_writ_need(): require writ type.
@@ -276,6 +492,11 @@ _lord_plea_live(u3_lord* god_u, u3_noun dat)
       //
       u3l_log("pier: pack complete");
     } break;
+
+    //  the serf reports if it actually packed
+    //
+    case u3_writ_tidy: {
+    } break;
   }
 
   c3_free(wit_u);
@@ -293,12 +514,14 @@ _lord_plea_ripe(u3_lord* god_u, u3_noun dat)
   }
 
   {
-    u3_noun ver, pro, hon, noc, eve, mug;
+    u3_noun ver, pro, hon, noc, eve, mug, rin;
     c3_y pro_y, hon_y, noc_y;
     c3_d eve_d;
     c3_l mug_l;
 
-    if (  (c3n == u3r_trel(dat, &ver, &eve, &mug))
+    if (  (c3n == u3r_qual(dat, &ver, &eve, &mug, &rin))
+       || (c3n == u3a_is_cat(rin))
+       || (rin > 1)
        || (c3n == u3r_trel(ver, &pro, &hon, &noc))
        || (c3n == u3r_safe_byte(pro, &pro_y))
        || (c3n == u3r_safe_byte(hon, &hon_y))
@@ -319,6 +542,13 @@ _lord_plea_ripe(u3_lord* god_u, u3_noun dat)
     god_u->mug_l = mug_l;
     god_u->hon_y = hon_y;
     god_u->noc_y = noc_y;
+
+    //  the serf couldn't map the replay ring; send batches as lists
+    //
+    if ( (c3n == rin) && god_u->rin_u.buf_y ) {
+      fprintf(stderr, "lord: ring: unavailable to serf, using pipe\r\n");
+      _lord_ring_done(god_u);
+    }
   }
 
   god_u->liv_o = c3y;
@@ -497,6 +727,7 @@ _lord_plea_play(u3_lord* god_u, u3_noun dat)
   {
     u3_writ* wit_u = _lord_writ_need(god_u, u3_writ_play);
     fon_u = wit_u->fon_u;
+    _lord_ring_free(god_u, wit_u);
     c3_free(wit_u);
   }
 
@@ -780,14 +1011,23 @@ _lord_writ_make(u3_lord* god_u, u3_writ* wit_u)
     case u3_writ_play: {
       u3_fact* tac_u = wit_u->fon_u.ext_u;
       c3_d     eve_d = tac_u->eve_d;
-      u3_noun    lit = u3_nul;
+      u3_noun    lit = _lord_ring_play(god_u, wit_u);
 
-      while ( tac_u ) {
-        lit   = u3nc(u3k(tac_u->job), lit);
-        tac_u = tac_u->nex_u;
+      //  uncued events are passed through the ring, as stored,
+      //  or decoded here if the batch does not fit
+      //
+      if ( u3_none == lit ) {
+        lit = u3_nul;
+
+        while ( tac_u ) {
+          lit   = u3nc(u3k(u3_fact_cue(tac_u)), lit);
+          tac_u = tac_u->nex_u;
+        }
+
+        lit = u3kb_flop(lit);
       }
 
-      msg = u3nt(c3__play, u3i_chubs(1, &eve_d), u3kb_flop(lit));
+      msg = u3nt(c3__play, u3i_chubs(1, &eve_d), lit);
 
     } break;
 
@@ -807,6 +1047,10 @@ _lord_writ_make(u3_lord* god_u, u3_writ* wit_u)
       msg = u3nt(c3__live, c3__pack, u3_nul);
     } break;
 
+    case u3_writ_tidy: {
+      msg = u3nq(c3__live, c3__pack, c3__auto, u3_Host.ops_u.pac_w);
+    } break;
+
     case u3_writ_exit: {
       //  requested exit code is always 0
       //
@@ -998,6 +1242,16 @@ u3_lord_pack(u3_lord* god_u)
   _lord_writ_plan(god_u, wit_u);
 }
 
+/* u3_lord_tidy(): defragment persistent state, if fragmented.
+*/
+void
+u3_lord_tidy(u3_lord* god_u)
+{
+  u3_writ* wit_u = _lord_writ_new(god_u);
+  wit_u->typ_e = u3_writ_tidy;
+  _lord_writ_plan(god_u, wit_u);
+}
+
 /* u3_lord_exit(): shutdown gracefully.
 */
 void
@@ -1134,6 +1388,15 @@ u3_lord_slog(u3_lord* god_u)
           god_u->eve_d,
           god_u->mug_l,
           god_u->dep_w);
+
+  if ( god_u->rin_u.buf_y ) {
+    u3l_log("  lord: ring: %u batches, %" PRIu64 "-%" PRIu64 " of %" PRIu64,
+            god_u->rin_u.out_w,
+            god_u->rin_u.tal_d,
+            god_u->rin_u.hed_d,
+            god_u->rin_u.siz_d);
+  }
+
   u3_newt_moat_slog(&god_u->out_u);
 }
 
@@ -1158,7 +1421,7 @@ u3_lord_init(c3_c* pax_c, c3_w wag_w, c3_d key_d[4], u3_lord_cb cb_u)
   //  spawn new process and connect to it
   //
   {
-    c3_c* arg_c[9];
+    c3_c* arg_c[10];
     c3_c  key_c[256];
     c3_c  wag_c[11];
     c3_c  hap_c[11];
@@ -1195,7 +1458,12 @@ u3_lord_init(c3_c* pax_c, c3_w wag_w, c3_d key_d[4], u3_lord_cb cb_u)
       arg_c[7] = "0";
     }
 
-    arg_c[8] = NULL;
+    //  the serf maps the replay ring before it reports %ripe
+    //
+    _lord_ring_init(god_u);
+    arg_c[8] = ( god_u->rin_u.buf_y ) ? god_u->rin_u.nam_c : "0";
+
+    arg_c[9] = NULL;
 
     uv_pipe_init(u3L, &god_u->inn_u.pyp_u, 0);
     uv_timer_init(u3L, &god_u->out_u.tim_u);
@@ -1222,6 +1490,7 @@ u3_lord_init(c3_c* pax_c, c3_w wag_w, c3_d key_d[4], u3_lord_cb cb_u)
 
     if ( (err_i = uv_spawn(u3L, &god_u->cub_u, &god_u->ops_u)) ) {
       fprintf(stderr, "spawn: %s: %s\r\n", arg_c[0], uv_strerror(err_i));
+      _lord_ring_done(god_u);
 
       return 0;
     }
@@ -154,6 +154,11 @@ _main_init(void)
 
   u3_Host.ops_u.net = c3y;
   u3_Host.ops_u.lit = c3n;
+  u3_Host.ops_u.laz = c3n;
+  u3_Host.ops_u.sof = c3n;
+  u3_Host.ops_u.gra_w = 16;
+  u3_Host.ops_u.out = c3n;
+  u3_Host.ops_u.pac_w = 0;
   u3_Host.ops_u.nuu = c3n;
   u3_Host.ops_u.pro = c3n;
   u3_Host.ops_u.qui = c3n;
@@ -246,6 +251,15 @@ _main_getopt(c3_i argc, c3_c** argv)
     { "scry-format",         required_argument, NULL, 'Z' },
     //
     { "urth-loom",           required_argument, NULL, 5 },
+    { "replay-prefetch",     required_argument, NULL, 9 },
+    { "commit-delay",        required_argument, NULL, 6 },
+    { "commit-events",       required_argument, NULL, 7 },
+    { "commit-sync",         required_argument, NULL, 8 },
+    { "lazy-loom",           no_argument,       NULL, 10 },
+    { "soft-dirty",          no_argument,       NULL, 11 },
+    { "loom-page",           required_argument, NULL, 12 },
+    { "page-out",            no_argument,       NULL, 13 },
+    { "auto-pack",           required_argument, NULL, 14 },
     //
     { NULL, 0, NULL, 0 },
   };
@@ -266,6 +280,80 @@ _main_getopt(c3_i argc, c3_c** argv)
         u3_Host.ops_u.lut_y = lut_w;
         break;
       }
+      case 9: {  //  replay-prefetch
+        if ( c3n == _main_readw(optarg, 65, &u3_Host.ops_u.pre_w) ) {
+          fprintf(stderr, "error: --replay-prefetch must be <= 64\r\n");
+          return c3n;
+        }
+        break;
+      }
+      case 6: {  //  commit-delay
+        if ( c3n == _main_readw(optarg, 60000, &u3_Host.ops_u.cod_w) ) {
+          fprintf(stderr, "error: --commit-delay must be < 60000 (ms)\r\n");
+          return c3n;
+        }
+        break;
+      }
+      case 7: {  //  commit-events
+        if ( c3n == _main_readw(optarg, 1000000, &u3_Host.ops_u.coe_w) ) {
+          fprintf(stderr, "error: --commit-events must be < 1000000\r\n");
+          return c3n;
+        }
+        break;
+      }
+      case 8: {  //  commit-sync
+        if ( !strcmp(optarg, "full") ) {
+          u3_Host.ops_u.syn_y = u3_lmdb_sync_full;
+        }
+        else if ( !strcmp(optarg, "meta") ) {
+          u3_Host.ops_u.syn_y = u3_lmdb_sync_meta;
+        }
+        else if ( !strcmp(optarg, "none") ) {
+          u3_Host.ops_u.syn_y = u3_lmdb_sync_none;
+        }
+        else {
+          fprintf(stderr, "error: --commit-sync must be full, meta, or none\r\n");
+          return c3n;
+        }
+        break;
+      }
+      case 10: {  //  lazy-loom
+        u3_Host.ops_u.laz = c3y;
+        break;
+      }
+      case 11: {  //  soft-dirty
+        u3_Host.ops_u.sof = c3y;
+        break;
+      }
+      case 12: {  //  loom-page
+        if ( !strcmp(optarg, "16K") ) {
+          u3_Host.ops_u.gra_w = 16;
+        }
+        else if ( !strcmp(optarg, "64K") ) {
+          u3_Host.ops_u.gra_w = 64;
+        }
+        else if ( !strcmp(optarg, "2M") ) {
+          u3_Host.ops_u.gra_w = 2048;
+        }
+        else {
+          fprintf(stderr, "error: --loom-page must be 16K, 64K, or 2M\r\n");
+          return c3n;
+        }
+        break;
+      }
+      case 13: {  //  page-out
+        u3_Host.ops_u.out = c3y;
+        break;
+      }
+      case 14: {  //  auto-pack
+        if (  (c3n == _main_readw(optarg, 1 << 16, &u3_Host.ops_u.pac_w))
+           || !u3_Host.ops_u.pac_w )
+        {
+          fprintf(stderr, "error: --auto-pack must be > 0 and < 65536 (MB)\r\n");
+          return c3n;
+        }
+        break;
+      }
       case 'X': {
         u3_Host.ops_u.pek_c = strdup(optarg);
         break;
@@ -664,6 +752,7 @@ _cw_usage(c3_c* bin_c)
     "  %s next %.*s              request upgrade:\n",
     "  %s queu %.*s<at-event>    cue state:\n",
     "  %s chop %.*s              truncate event log:\n",
+    "  %s scan %.*s              verify event log index:\n",
     "  %s vere ARGS <output dir>    download binary:\n",
     "\n  run as a 'serf':\n",
     "    %s serf <pier> <key> <flags> <cache-size> <at-event>"
@@ -737,6 +826,15 @@ u3_ve_usage(c3_i argc, c3_c** argv)
     "-Z, --scry-format FORMAT      Optional file format ('jam', or aura, for -X)\n",
     "    --no-conn                 Do not run control plane\n",
     "    --no-dock                 Skip binary \"docking\" on boot\n",
+    "    --replay-prefetch N       Keep N event-log reads in flight on replay\n",
+    "    --commit-delay MS         Group event-log commits, waiting up to MS\n",
+    "    --commit-events N         Commit early once N events are pending\n",
+    "    --commit-sync POLICY      Commit sync: full (default), meta, none (unsafe)\n",
+    "    --lazy-loom               Page the snapshot into memory on demand\n",
+    "    --soft-dirty              Track loom writes with soft-dirty bits (linux)\n",
+    "    --loom-page SIZE          Track loom writes in 16K (default), 64K, or 2M pages\n",
+    "    --page-out                Release long-unchanged loom memory to the page cache\n",
+    "    --auto-pack MB            Pack the loom when idle and fragmented, if heap < MB\n",
     "\n",
     "Development Usage:\n",
     "   To create a development ship, use a fakezod:\n",
@@ -951,6 +1049,11 @@ static void
 _cw_serf_exit(void)
 {
   u3s_cue_xeno_done(sil_u);
+
+  if ( u3V.sil_u ) {
+    u3s_cue_xeno_done(u3V.sil_u);
+  }
+
   u3t_trace_close();
 }
 
@@ -1023,6 +1126,7 @@ _cw_serf_commence(c3_i argc, c3_c* argv[])
   c3_c*      lom_c = argv[6];
   c3_w       lom_w;
   c3_c*      eve_c = argv[7];
+  c3_c*      rin_c = ( 8 < argc ) ? argv[8] : "0";
 
   _cw_init_io(lup_u);
 
@@ -1099,6 +1203,12 @@ _cw_serf_commence(c3_i argc, c3_c* argv[])
   u3t_trace_open(u3V.dir_c);
 #endif
 
+  //  map the replay ring, if the king made one
+  //
+  if ( strcmp(rin_c, "0") ) {
+    u3_serf_ring(&u3V, rin_c);
+  }
+
   //  start serf
   //
   {
@@ -1121,7 +1231,15 @@ static u3_disk*
 _cw_disk_init(c3_c* dir_c)
 {
   u3_disk_cb cb_u = {0};
-  u3_disk*  log_u = u3_disk_init(dir_c, cb_u);
+  u3_disk*  log_u;
+
+  //  the event log keeps handles on the loop, even when not running it
+  //
+  if ( !u3L ) {
+    u3L = uv_default_loop();
+  }
+
+  log_u = u3_disk_init(dir_c, cb_u);
 
   if ( !log_u ) {
     fprintf(stderr, "unable to open event log\n");
@@ -1751,18 +1869,26 @@ _cw_play(c3_i argc, c3_c* argv[])
 
   static const c3_c usage_c[] = "error: invalid usage, expected "
                                 "`urbit play [--replay-to <event_num> "
-                                "| --batch-size <event_cnt>] <pier>`";
+                                "| --batch-size <event_cnt> "
+                                "| --prefetch <read_cnt>] <pier>`";
   static struct option lop_u[] = {
     { "batch-size", required_argument, NULL, 'b' },
     { "replay-to",  required_argument, NULL, 'n' },
+    { "prefetch",   required_argument, NULL, 'f' },
     { NULL,         0,                 NULL, 0   }
   };
 
-  while ( -1 != (ch_i = getopt_long(argc, argv, "b:n:", lop_u, &lid_i)) ) {
+  while ( -1 != (ch_i = getopt_long(argc, argv, "b:f:n:", lop_u, &lid_i)) ) {
     switch ( ch_i ) {
       case 'b':
         u3_Host.ops_u.batch_sz_c = strdup(optarg);
         break;
+      case 'f':
+        if ( c3n == _main_readw(optarg, 65, &u3_Host.ops_u.pre_w) ) {
+          fprintf(stderr, "%s\r\n", usage_c);
+          exit(1);
+        }
+        break;
       case 'n':
         u3_Host.ops_u.til_c = strdup(optarg);
         break;
@@ -1923,105 +2049,162 @@ _cw_chop(c3_i argc, c3_c* argv[])
     exit(1);
   }
 
-  // initialize the lmdb environment
-  // see disk.c:885
-  const size_t siz_i =
-  // 500 GiB is as large as musl on aarch64 wants to allow
-  #if (defined(U3_CPU_aarch64) && defined(U3_OS_linux))
-    0x7d00000000;
-  #else
-    0x10000000000;
-  #endif
-  c3_c log_c[8193];
-  snprintf(log_c, sizeof(log_c), "%s/.urb/log", u3_Host.dir_c);
-
-  // get the first/last event numbers from the event log
-  c3_d fir_d, las_d;
-  if ( c3n == u3_lmdb_gulf(old_u->mdb_u, &fir_d, &las_d) ) {
-    fprintf(stderr, "chop: failed to load latest event from database\r\n");
+  // start a new epoch at the current snapshot
+  c3_d eve_d = old_u->dun_d;
+  if ( c3n == u3_disk_roll(old_u, eve_d) ) {
+    fprintf(stderr, "chop: failed to start a new epoch\r\n");
     exit(1);
   }
 
-  // get the metadata
-  c3_d     who_d[2];
-  c3_o     fak_o;
-  c3_w     lif_w;
-  if ( c3y != u3_disk_read_meta(old_u->mdb_u, who_d, &fak_o, &lif_w) ) {
-    fprintf(stderr, "chop: failed to read metadata\r\n");
+  // delete all epochs before it, but the previous one
+  if ( c3n == u3_disk_chop(old_u, eve_d) ) {
+    fprintf(stderr, "chop: failed to delete old epochs\r\n");
     exit(1);
   }
 
-  // get the last event
-  u3_lmdb_walk itr_u;
-  size_t       len_i;
-  void*        buf_v[1];
-  if ( c3n == u3_lmdb_walk_init(old_u->mdb_u, &itr_u, las_d, las_d) ) {
-    fprintf(stderr, "chop: failed to initialize iterator\r\n");
-    exit(1);
-  }
-  if ( c3n == u3_lmdb_walk_next(&itr_u, &len_i, buf_v) ) {
-    fprintf(stderr, "chop: failed to read event\r\n");
-    exit(1);
-  }
-  u3_lmdb_walk_done(&itr_u);
+  c3_d fir_d = old_u->epo_u->epo_d;
 
-  // initialize a fresh lmdb environment in the "chop" subdir
-  c3_c cho_c[8193];
-  snprintf(cho_c, sizeof(cho_c), "%s/chop", log_c);
-  if ( 0 != access(cho_c, F_OK) ) {
-    if ( 0 != c3_mkdir(cho_c, 0700) ) {
-      fprintf(stderr, "chop: failed to create chop directory\r\n");
-      exit(1);
-    }
+  // cleanup
+  u3_disk_exit(old_u);
+  u3m_stop();
+
+  // success
+  fprintf(stderr, "chop: event log truncation complete\r\n");
+  if ( fir_d ) {
+    fprintf(stderr, "      events up to %" PRIu64 " are now only in the snapshot\r\n", fir_d);
   }
-  MDB_env* new_u = u3_lmdb_init(cho_c, siz_i);
-  if ( !new_u ) {
-    fprintf(stderr, "chop: failed to initialize new database\r\n");
-    exit(1);
+  else {
+    fprintf(stderr, "      no events were deleted\r\n");
   }
+  fprintf(stderr, "      snapshot backup written to .urb/bhk\r\n");
 
-  // write the metadata to the database
-  if ( c3n == u3_disk_save_meta(new_u, who_d, fak_o, lif_w) ) {
-    fprintf(stderr, "chop: failed to save metadata\r\n");
-    exit(1);
+  if ( fir_d < eve_d ) {
+    fprintf(stderr, "      the previous epoch (events %" PRIu64 " to %" PRIu64 ") "
+                    "is kept in %s/.urb/log/0i%" PRIu64 "\r\n",
+                    fir_d + 1, eve_d, u3_Host.dir_c, fir_d);
+    fprintf(stderr, "      to restore the snapshot, shut down the pier and "
+                    "copy .urb/bhk/*.bin over .urb/chk/\r\n");
+    fprintf(stderr, "      the next chop will delete the kept epoch\r\n");
   }
+}
 
-  // write the last event to the database
-  // warning: this relies on the old database still being open
-  if ( c3n == u3_lmdb_save(new_u, las_d, 1, buf_v, &len_i) ) {
-    fprintf(stderr, "chop: failed to write last event\r\n");
-    exit(1);
+/* _cw_scan(): verify event log against its index.
+*/
+static void
+_cw_scan(c3_i argc, c3_c* argv[])
+{
+  c3_i ch_i, lid_i;
+  c3_d eve_d = 0;
+  c3_d fir_d = 1;
+  c3_d las_d = ~0ULL;
+  c3_w thr_w = 0;
+  c3_o fix_o = c3n;
+
+  static const c3_c usage_c[] = "error: invalid usage, expected "
+                                "`urbit scan [--event <event_num> "
+                                "| --from <event_num> | --to <event_num> "
+                                "| --threads <thread_cnt> | --index] <pier>`";
+  static struct option lop_u[] = {
+    { "event",   required_argument, NULL, 'e' },
+    { "from",    required_argument, NULL, 'f' },
+    { "to",      required_argument, NULL, 't' },
+    { "threads", required_argument, NULL, 'j' },
+    { "index",   no_argument,       NULL, 'i' },
+    { NULL,      0,                 NULL, 0   }
+  };
+
+  while ( -1 != (ch_i = getopt_long(argc, argv, "e:f:t:j:i", lop_u, &lid_i)) ) {
+    switch ( ch_i ) {
+      case 'e':
+        if ( 1 != sscanf(optarg, "%" PRIu64, &eve_d) ) {
+          fprintf(stderr, "%s\r\n", usage_c);
+          exit(1);
+        }
+        break;
+      case 'f':
+        if ( 1 != sscanf(optarg, "%" PRIu64, &fir_d) ) {
+          fprintf(stderr, "%s\r\n", usage_c);
+          exit(1);
+        }
+        break;
+      case 't':
+        if ( 1 != sscanf(optarg, "%" PRIu64, &las_d) ) {
+          fprintf(stderr, "%s\r\n", usage_c);
+          exit(1);
+        }
+        break;
+      case 'j':
+        if ( c3n == _main_readw(optarg, 1025, &thr_w) ) {
+          fprintf(stderr, "%s\r\n", usage_c);
+          exit(1);
+        }
+        break;
+      case 'i':
+        fix_o = c3y;
+        break;
+      case '?':
+        fprintf(stderr, "%s\r\n", usage_c);
+        exit(1);
+    }
   }
 
-  // backup the original database file
-  c3_c dat_c[8193], bak_c[8193];
-  snprintf(dat_c, sizeof(dat_c), "%s/data.mdb", log_c);
-  // "data_<first>-<last>.mdb.bak"
-  snprintf(bak_c, sizeof(bak_c), "%s/data_%" PRIu64 "-%" PRIu64 ".mdb.bak", cho_c, fir_d, las_d);
-  if ( 0 != c3_rename(dat_c, bak_c) ) {
-    fprintf(stderr, "chop: failed to backup original database file\r\n");
-    exit(1);
+  u3_Host.dir_c = _main_pier_run(argv[0]);
+
+  //  argv[optind] is always "scan"
+  //
+  if ( !u3_Host.dir_c ) {
+    if ( optind + 1 < argc ) {
+      u3_Host.dir_c = argv[optind + 1];
+    }
+    else {
+      fprintf(stderr, "%s\r\n", usage_c);
+      exit(1);
+    }
+
+    optind++;
   }
 
-  // rename new database file to be official
-  c3_c new_c[8193];
-  snprintf(new_c, sizeof(new_c), "%s/data.mdb", cho_c);
-  if ( 0 != c3_rename(new_c, dat_c) ) {
-    fprintf(stderr, "chop: failed to rename new database file\r\n");
+  if ( optind + 1 != argc ) {
+    fprintf(stderr, "%s\r\n", usage_c);
     exit(1);
   }
 
-  // cleanup
-  u3_disk_exit(old_u);
-  u3_lmdb_exit(new_u);
-  u3m_stop();
+  //  the event log is read without the snapshot
+  //
+  u3m_boot_lite(u3a_bytes);
 
-  // success
-  fprintf(stderr, "chop: event log truncation complete\r\n");
-  fprintf(stderr, "      event log backup written to %s\r\n", bak_c);
-  fprintf(stderr, "      WARNING: ENSURE YOU CAN RESTART YOUR SHIP BEFORE DELETING YOUR EVENT LOG BACKUP FILE!\r\n");
-  fprintf(stderr, "      if you can't, restore your log by running:\r\n");
-  fprintf(stderr, "      `mv %s %s` then try again\r\n", bak_c, dat_c);
+  {
+    u3_disk* log_u = _cw_disk_init(u3_Host.dir_c);
+    c3_o     ret_o;
+
+    if ( eve_d ) {
+      c3_l mug_l;
+      c3_d len_d, siz_d;
+      c3_o dex_o;
+
+      ret_o = u3_disk_index(log_u, eve_d, &mug_l, &len_d, &siz_d, &dex_o);
+
+      if ( c3y == ret_o ) {
+        fprintf(stderr, "scan: event %" PRIu64 ": mug %x, "
+                        "%" PRIu64 " bytes jammed, %" PRIu64 " stored%s\r\n",
+                        eve_d, mug_l, len_d, siz_d,
+                        ( c3y == dex_o ) ? "" : " (unindexed)");
+      }
+      else {
+        fprintf(stderr, "scan: event %" PRIu64 " not found\r\n", eve_d);
+      }
+    }
+    else {
+      ret_o = u3_disk_scan(log_u, fir_d, las_d, thr_w, fix_o);
+    }
+
+    u3_disk_exit(log_u);
+    u3m_stop();
+
+    if ( c3n == ret_o ) {
+      exit(1);
+    }
+  }
 }
 
 /* _cw_vere(): download vere
@@ -2248,6 +2431,7 @@ _cw_utils(c3_i argc, c3_c* argv[])
   //        [%pack dir=@t]                                ::  defragment
   //        [%prep dir=@t]                                ::  prep upgrade
   //        [%queu dir=@t eve=@ud]                        ::  cue state
+  //        [%scan dir=@t]                                ::  verify log
   //        [?(%vere %fetch-vere) dir=@t]                 ::  download vere
   //        [%vile dir=@t]                                ::  extract keys
   //    ::                                                ::    ipc:
@@ -2290,6 +2474,7 @@ _cw_utils(c3_i argc, c3_c* argv[])
     case c3__prep: _cw_prep(argc, argv); return 2; // continue on
     case c3__queu: _cw_queu(argc, argv); return 1;
     case c3__chop: _cw_chop(argc, argv); return 1;
+    case c3__scan: _cw_scan(argc, argv); return 1;
     case c3__vere: _cw_vere(argc, argv); return 1;
     case c3__vile: _cw_vile(argc, argv); return 1;
 
@@ -2459,6 +2644,33 @@ main(c3_i   argc,
       if ( _(u3_Host.ops_u.tra) ) {
         u3C.wag_w |= u3o_trace;
       }
+
+      /*  Set demand-paging flag
+      */
+      if ( _(u3_Host.ops_u.laz) ) {
+        u3C.wag_w |= u3o_lazy;
+      }
+
+      /*  Set soft-dirty flag
+      */
+      if ( _(u3_Host.ops_u.sof) ) {
+        u3C.wag_w |= u3o_soft;
+      }
+
+      /*  Set dirty-tracking page size
+      */
+      if ( 64 == u3_Host.ops_u.gra_w ) {
+        u3C.wag_w |= u3o_page_big;
+      }
+      else if ( 2048 == u3_Host.ops_u.gra_w ) {
+        u3C.wag_w |= u3o_page_huge;
+      }
+
+      /*  Set page-out flag
+      */
+      if ( _(u3_Host.ops_u.out) ) {
+        u3C.wag_w |= u3o_page_out;
+      }
     }
 
     //  starting u3m configures OpenSSL memory functions, so we must do it
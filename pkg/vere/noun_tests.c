@@ -1739,6 +1739,129 @@ _test_nvm_stack()
 #endif
 }
 
+/* _test_shed(): deferred losses drain incrementally, without leaks.
+*/
+static c3_i
+_test_shed(void)
+{
+  c3_i    ret_i = 1;
+  c3_w    i_w, dan_w = 0;
+  u3_noun lis = u3_nul;
+
+  for ( i_w = 0; i_w < 100000; i_w++ ) {
+    lis = u3nc(u3i_chub(0x100000000ULL + i_w), lis);
+  }
+
+  u3a_shed(lis);
+
+  //  the queue is a root, so a partial drain must not leak
+  //
+  if ( c3y == u3a_flush(1000) ) {
+    fprintf(stderr, "test shed: drained early\r\n");
+    ret_i = 0;
+  }
+
+  u3m_grab(u3_none);
+
+  while ( c3n == u3a_flush(1000) ) {
+    dan_w++;
+  }
+
+  if ( dan_w < 100 ) {
+    fprintf(stderr, "test shed: %u drains\r\n", dan_w);
+    ret_i = 0;
+  }
+
+  if ( u3_nul != u3R->laz ) {
+    fprintf(stderr, "test shed: queue not empty\r\n");
+    ret_i = 0;
+  }
+
+  u3m_grab(u3_none);
+
+  return ret_i;
+}
+
+/* _test_align(): allocations stay granule-aligned, and references round-trip.
+*/
+static c3_i
+_test_align(void)
+{
+  c3_i    ret_i = 1;
+  c3_w    i_w;
+  u3_noun lis = u3_nul;
+
+  for ( i_w = 1; i_w < 64; i_w++ ) {
+    c3_w* buf_w = u3a_walloc(i_w);
+    c3_w* byt_w = u3a_malloc(i_w);
+
+    if ( u3a_outa(buf_w) % u3a_walign ) {
+      fprintf(stderr, "test align: walloc %u unaligned\r\n", i_w);
+      ret_i = 0;
+    }
+
+    //  interleave atoms, so that trimmed and freed boxes
+    //  are carved up again
+    //
+    lis = u3nc(u3qc_bex(i_w * 7), lis);
+
+    u3a_wfree(buf_w);
+    u3a_free(byt_w);
+  }
+
+  {
+    u3_noun i = lis;
+
+    while ( u3_nul != i ) {
+      u3_noun hed = u3h(i);
+
+      if (  (u3a_to_pom(u3a_to_off(i)) != i)
+         || ((c3y == u3a_is_pug(hed)) && (u3a_to_pug(u3a_to_off(hed)) != hed)) )
+      {
+        fprintf(stderr, "test align: reference mismatch\r\n");
+        ret_i = 0;
+      }
+
+      i = u3t(i);
+    }
+  }
+
+  u3z(lis);
+
+  //  references must round-trip across the whole addressable loom,
+  //  which is only past 4GB (2^30 words) when pointers are shifted
+  //
+  {
+    c3_w off_w[] = { u3a_walign,
+                     (u3a_words >> 1),
+                     (u3a_words >> 1) + u3a_walign,
+                     u3a_words - (u3a_walign << 1),
+                     u3a_words - u3a_walign };
+
+    if ( u3a_vits && (off_w[4] < (1U << 30)) ) {
+      fprintf(stderr, "test align: loom ends at word %x\r\n", off_w[4]);
+      ret_i = 0;
+    }
+
+    for ( i_w = 0; i_w < sizeof(off_w) / sizeof(c3_w); i_w++ ) {
+      c3_w  fof_w = off_w[i_w];
+      c3_w* ptr_w = u3a_into(fof_w);
+
+      if (  (u3a_to_off(u3a_to_pom(fof_w)) != fof_w)
+         || (u3a_to_off(u3a_to_pug(fof_w)) != fof_w)
+         || (u3a_to_ptr(u3a_to_pom(fof_w)) != (void*)ptr_w)
+         || (u3h_slot_to_node(u3h_node_to_slot(ptr_w)) != (void*)ptr_w) )
+      {
+        fprintf(stderr, "test align: offset %x does not round-trip\r\n",
+                        fof_w);
+        ret_i = 0;
+      }
+    }
+  }
+
+  return ret_i;
+}
+
 static c3_i
 _test_noun(void)
 {
@@ -1749,6 +1872,16 @@ _test_noun(void)
     ret_i = 0;
   }
 
+  if ( !_test_shed() ) {
+    fprintf(stderr, "test noun: shed failed\r\n");
+    ret_i = 0;
+  }
+
+  if ( !_test_align() ) {
+    fprintf(stderr, "test noun: align failed\r\n");
+    ret_i = 0;
+  }
+
   return ret_i;
 }
 
@@ -7,10 +7,31 @@
 #include "version.h"
 
 #define PIER_READ_BATCH 1000ULL
+#define PIER_READ_AHEAD 2
 #define PIER_WORK_BATCH 10ULL
 
-/// The default replay batch size. This can be overridden at the command line.
-static c3_d replay_batch_sz_d = 500ULL;
+/// Start a new event-log epoch at the first snapshot this many events into
+/// the current one.
+#define PIER_EPOC_EVENTS 1000000ULL
+
+/// Replay batches start at this size, then are resized so that the serf
+/// spends about PIER_PLAY_TIME on each one.
+#define PIER_PLAY_BATCH     500ULL
+#define PIER_PLAY_BATCH_MIN 10ULL
+#define PIER_PLAY_BATCH_MAX 10000ULL
+#define PIER_PLAY_TIME      (500ULL * 1000000ULL)
+
+/// Snapshot during replay once this much time has passed since the last
+/// one, and at least PIER_PLAY_SAVE_COST times as long as it took.
+#define PIER_PLAY_SAVE      (120ULL * 1000000000ULL)
+#define PIER_PLAY_SAVE_COST 20ULL
+
+/// Ask the serf to compact its loom, if fragmented, when the event queue
+/// drains and at least this many milliseconds have passed since the last ask.
+#define PIER_TIDY_GAP (30ULL * 60ULL * 1000ULL)
+
+/// A fixed replay batch size, if specified at the command line.
+static c3_d replay_batch_sz_d = 0ULL;
 
 #undef VERBOSE_PIER
 
@@ -384,6 +405,30 @@ _pier_work_afte_cb(uv_check_t* cek_u)
   _pier_work(wok_u);
 }
 
+/* _pier_work_tidy(): with --auto-pack, request a conditional pack
+**                    if the serf is idle.
+*/
+static void
+_pier_work_tidy(u3_work* wok_u)
+{
+  u3_pier* pir_u = wok_u->pir_u;
+  u3_lord* god_u = pir_u->god_u;
+  c3_d     now_d = uv_now(u3L);
+
+  if (  !u3_Host.ops_u.pac_w
+     || (u3_psat_work != pir_u->sat_e)
+     || (c3n == pir_u->liv_o)
+     || wok_u->wal_u
+     || god_u->ent_u
+     || ((now_d - wok_u->tid_d) < PIER_TIDY_GAP) )
+  {
+    return;
+  }
+
+  wok_u->tid_d = now_d;
+  u3_lord_tidy(god_u);
+}
+
 /* _pier_work_idle_cb(): run on next loop iteration.
 */
 static void
@@ -391,6 +436,7 @@ _pier_work_idle_cb(uv_idle_t* idl_u)
 {
   u3_work* wok_u = idl_u->data;
   _pier_work(wok_u);
+  _pier_work_tidy(wok_u);
   uv_idle_stop(idl_u);
 }
 
@@ -543,6 +589,7 @@ _pier_work_init(u3_pier* pir_u)
   pir_u->wok_u = wok_u = c3_calloc(sizeof(*wok_u));
   wok_u->pir_u = pir_u;
   wok_u->fec_u.rel_d = pir_u->log_u->dun_d;
+  wok_u->tid_d = uv_now(u3L);
 
   _pier_work_time(pir_u);
 
@@ -942,18 +989,29 @@ _pier_play_send(u3_play* pay_u)
     return;
   }
 
-  //  XX fill the pipe how much?
-  // (god_u->dep_w > PIER_WORK_BATCH) )
+  //  draining the serf for a snapshot
   //
+  if ( c3y == pay_u->sav_o ) {
+    return;
+  }
 
   //  the first batch must be >= the lifecycle barrier
   //
   if ( !pay_u->sen_d ) {
-    len_w = c3_max(pir_u->lif_w, replay_batch_sz_d - 1);
+    len_w = c3_max(pir_u->lif_w, pay_u->bat_d - 1);
   }
   else {
     c3_d lef_d = (pay_u->eve_d - pay_u->sen_d);
-    len_w = c3_min(lef_d, replay_batch_sz_d - 1);
+    len_w = c3_min(lef_d, pay_u->bat_d - 1);
+
+    //  while the serf is busy, wait for a full batch
+    //
+    if (  pay_u->fly_w
+       && (pay_u->ent_u->eve_d < pay_u->eve_d)
+       && ((pay_u->ent_u->eve_d - pay_u->sen_d) <= len_w) )
+    {
+      return;
+    }
   }
 
   {
@@ -967,47 +1025,47 @@ _pier_play_send(u3_play* pay_u)
     fprintf(stderr, "pier: play send %" PRIu64 "-%" PRIu64 "\r\n", fon_u.ext_u->eve_d, fon_u.ent_u->eve_d);
 #endif
 
+    if ( !pay_u->fly_w++ ) {
+      pay_u->tim_d = uv_hrtime();
+    }
+
     u3_lord_play(pir_u->god_u, fon_u);
-    // Save a snaphot when replaying the batch completes.
-    u3_lord_save(pir_u->god_u);
   }
 }
 
 /* _pier_play_read(): read events from disk for replay.
+**
+**   keeps up to [pre_w] reads in flight, so that disk reads overlap
+**   with serf computation, bounding the events buffered ahead.
 */
 static void
 _pier_play_read(u3_play* pay_u)
 {
   u3_pier* pir_u = pay_u->pir_u;
-  c3_d las_d;
+  c3_w     pre_w = ( u3_Host.ops_u.pre_w )
+                   ? u3_Host.ops_u.pre_w
+                   : PIER_READ_AHEAD;
 
-  if ( pay_u->ent_u ) {
-    las_d = pay_u->ent_u->eve_d;
-
-    //  cap the pir_u->pay_u queue depth
-    //
-    if ( (las_d - pay_u->ext_u->eve_d) >= replay_batch_sz_d - 1 ) {
-      return;
-    }
-  }
-  else {
-    las_d = pay_u->sen_d;
-  }
+  c3_d     bat_d = c3_max(PIER_READ_BATCH, pay_u->bat_d);
 
+  while (  (pay_u->inf_w < pre_w)
+        && (pay_u->las_d < pay_u->eve_d)
+        && ((pay_u->las_d - pay_u->sen_d) < (pre_w * bat_d)) )
   {
-    c3_d nex_d = (1ULL + las_d);
-    c3_d len_d = c3_min(pay_u->eve_d - las_d, PIER_READ_BATCH);
+    c3_d nex_d = (1ULL + pay_u->las_d);
+    c3_d len_d = c3_min(pay_u->eve_d - pay_u->las_d, bat_d);
 
-    if (  len_d
-       && (nex_d > pay_u->req_d) )
-    {
-      u3_disk_read(pir_u->log_u, nex_d, len_d);
-      pay_u->req_d = nex_d;
+    //  with a replay ring, events are passed to the serf as stored
+    //
+    len_d = u3_disk_read(pir_u->log_u, nex_d, len_d,
+                         __(0 != pir_u->god_u->rin_u.buf_y));
+    pay_u->req_d  = nex_d;
+    pay_u->las_d += len_d;
+    pay_u->inf_w++;
 
 #ifdef VERBOSE_PIER
-      fprintf(stderr, "pier: play read %" PRIu64 " at %" PRIu64 "\r\n", len_d, nex_d);
+    fprintf(stderr, "pier: play read %" PRIu64 " at %" PRIu64 "\r\n", len_d, nex_d);
 #endif
-    }
   }
 }
 
@@ -1061,6 +1119,66 @@ _pier_play(u3_play* pay_u)
   }
 }
 
+/* _pier_play_time(): resize replay batches from serf time per event.
+*/
+static void
+_pier_play_time(u3_play* pay_u, c3_d len_d, c3_d now_d)
+{
+  c3_d per_d = (now_d - pay_u->tim_d) / len_d;
+
+  pay_u->per_d = ( pay_u->per_d )
+                 ? ((3ULL * pay_u->per_d) + per_d) / 4ULL
+                 : per_d;
+
+  if ( c3n == pay_u->fix_o ) {
+    c3_d bat_d = PIER_PLAY_TIME / c3_max(1ULL, pay_u->per_d);
+
+    bat_d = c3_max(PIER_PLAY_BATCH_MIN, bat_d);
+    pay_u->bat_d = c3_min(PIER_PLAY_BATCH_MAX, bat_d);
+  }
+
+  //  a pipelined batch starts when this one finishes
+  //
+  pay_u->tim_d = now_d;
+}
+
+/* _pier_play_save(): snapshot during replay, on a time budget.
+**
+**   the serf only snapshots with an empty queue, so we stop sending
+**   batches until those in flight are done; the snapshot must be
+**   infrequent enough that writing it is a small share of replay.
+*/
+static void
+_pier_play_save(u3_play* pay_u, c3_d now_d)
+{
+  u3_pier* pir_u = pay_u->pir_u;
+
+  //  the final snapshot is taken when playback completes
+  //
+  if ( pir_u->god_u->eve_d == pay_u->eve_d ) {
+    pay_u->sav_o = c3n;
+    return;
+  }
+
+  if ( c3n == pay_u->sav_o ) {
+    c3_d del_d = c3_max(PIER_PLAY_SAVE, PIER_PLAY_SAVE_COST * pay_u->cos_d);
+
+    if ( (now_d - pay_u->sav_d) < del_d ) {
+      return;
+    }
+
+    pay_u->sav_o = c3y;
+  }
+
+  if ( !pay_u->fly_w ) {
+    pay_u->tim_d = now_d;
+
+    if ( c3n == u3_lord_save(pir_u->god_u) ) {
+      pay_u->sav_o = c3n;
+    }
+  }
+}
+
 /* _pier_on_lord_play_done(): log replay batch completion from worker.
 */
 static void
@@ -1074,6 +1192,15 @@ _pier_on_lord_play_done(void* ptr_v, u3_info fon_u, c3_l mug_l)
 
   u3l_log("pier: (%" PRIu64 "): play: done", tac_u->eve_d);
 
+  {
+    u3_play* pay_u = pir_u->pay_u;
+    c3_d     now_d = uv_hrtime();
+
+    pay_u->fly_w--;
+    _pier_play_time(pay_u, 1ULL + tac_u->eve_d - fon_u.ext_u->eve_d, now_d);
+    _pier_play_save(pay_u, now_d);
+  }
+
   //  XX optional
   //
   if ( tac_u->mug_l && (tac_u->mug_l != mug_l) ) {
@@ -1162,7 +1289,7 @@ _pier_on_lord_play_bail(void* ptr_v, u3_info fon_u,
       u3_pier_punt_goof("play", dud);
       {
         u3_noun wir, tag;
-        u3x_qual(tac_u->job, 0, &wir, &tag, 0);
+        u3x_qual(u3_fact_cue(tac_u), 0, &wir, &tag, 0);
         u3_pier_punt_ovum("play", u3k(wir), u3k(tag));
       }
 
@@ -1193,6 +1320,18 @@ _pier_play_init(u3_pier* pir_u, c3_d eve_d)
   pay_u->pir_u = pir_u;
   pay_u->eve_d = eve_d;
   pay_u->sen_d = god_u->eve_d;
+  pay_u->las_d = god_u->eve_d;
+  pay_u->sav_o = c3n;
+  pay_u->sav_d = uv_hrtime();
+
+  if ( replay_batch_sz_d ) {
+    pay_u->bat_d = replay_batch_sz_d;
+    pay_u->fix_o = c3y;
+  }
+  else {
+    pay_u->bat_d = PIER_PLAY_BATCH;
+    pay_u->fix_o = c3n;
+  }
 
   u3l_log("---------------- playback starting ----------------");
   if ( (1ULL + god_u->eve_d) == eve_d ) {
@@ -1218,6 +1357,7 @@ _pier_on_disk_read_done(void* ptr_v, u3_info fon_u)
 
   c3_assert( u3_psat_play == pir_u->sat_e );
 
+  pir_u->pay_u->inf_w--;
   _pier_play_plan(pir_u->pay_u, fon_u);
   _pier_play(pir_u->pay_u);
 }
@@ -1311,6 +1451,34 @@ _pier_on_lord_save(void* ptr_v)
   fprintf(stderr, "pier: (%" PRIu64 "): lord: save\r\n", pir_u->god_u->eve_d);
 #endif
 
+  //  start a new epoch if the current one is large enough,
+  //  retrying at the next snapshot if the log is busy
+  //
+  if (  (u3_psat_work == pir_u->sat_e)
+     && (pir_u->god_u->eve_d >= (pir_u->log_u->epo_d + PIER_EPOC_EVENTS)) )
+  {
+    u3_disk_roll(pir_u->log_u, pir_u->god_u->eve_d);
+  }
+
+  //  resume replay after an intermediate snapshot
+  //
+  if (  (u3_psat_play == pir_u->sat_e)
+     && (c3y == pir_u->pay_u->sav_o) )
+  {
+    u3_play* pay_u = pir_u->pay_u;
+    c3_d     now_d = uv_hrtime();
+
+    pay_u->sav_o = c3n;
+    pay_u->cos_d = now_d - pay_u->tim_d;
+    pay_u->sav_d = now_d;
+
+    u3l_log("pier: (%" PRIu64 "): play: snapshot in %" PRIu64 "ms",
+            pir_u->god_u->eve_d,
+            pay_u->cos_d / 1000000ULL);
+
+    _pier_play(pay_u);
+  }
+
   // _pier_next(pir_u);
 }
 
@@ -1503,6 +1671,10 @@ u3_pier_info(u3_pier* pir_u)
           u3_pier_mase("target", u3i_chub(pay_u->eve_d)),
           u3_pier_mase("sent", u3i_chub(pay_u->sen_d)),
           u3_pier_mase("read", u3i_chub(pay_u->req_d)),
+          u3_pier_mase("read-final", u3i_chub(pay_u->las_d)),
+          u3_pier_mase("batch", u3i_chub(pay_u->bat_d)),
+          u3_pier_mase("event-ns", u3i_chub(pay_u->per_d)),
+          u3_pier_mase("save-ns", u3i_chub(pay_u->cos_d)),
           u3_none));
     } break;
 
@@ -1570,7 +1742,16 @@ u3_pier_slog(u3_pier* pir_u)
 
         u3l_log("  target: %" PRIu64, pay_u->eve_d);
         u3l_log("  sent: %" PRIu64, pay_u->sen_d);
-        u3l_log("  read: %" PRIu64, pay_u->req_d);
+        u3l_log("  read: %" PRIu64 " (%u in flight, through %" PRIu64 ")",
+                pay_u->req_d, pay_u->inf_w, pay_u->las_d);
+        u3l_log("  batch: %" PRIu64 "%s (%u in flight, %" PRIu64 "us/event)",
+                pay_u->bat_d,
+                ( c3y == pay_u->fix_o ) ? " fixed" : "",
+                pay_u->fly_w,
+                pay_u->per_d / 1000ULL);
+        u3l_log("  snapshot: %" PRIu64 "ms%s",
+                pay_u->cos_d / 1000000ULL,
+                ( c3y == pay_u->sav_o ) ? " (pending)" : "");
       }
     } break;
 
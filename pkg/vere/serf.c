@@ -4,6 +4,10 @@
 
 #include "vere.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 /*
 |%
 ::  +writ: from king to serf
@@ -23,13 +27,14 @@
       ==  ==
       [%peek mil=@ sam=*]  :: gang (each path $%([%once @tas @tas path] [beam @tas beam]))
       [%play eve=@ lit=(list ?((pair @da ovum) *))]
+      [%play eve=@ %ring nam=@t off=@ud len=@ud cnt=@ud]  ::  [len=@ jam]s
       [%work mil=@ job=(pair @da ovum)]
   ==
 ::  +plea: from serf to king
 ::
 +$  plea
   $%  [%live ~]
-      [%ripe [pro=%1 hon=@ nok=@] eve=@ mug=@]
+      [%ripe [pro=%1 hon=@ nok=@] eve=@ mug=@ rin=?]  ::  ring mapped?
       [%slog pri=@ tank]
       [%flog cord]
       $:  %peek
@@ -180,6 +185,38 @@ _serf_prof(FILE* fil_u, c3_w den, u3_noun mas)
   }
 }
 
+/* _serf_tide(): print loom watermarks and guard page telemetry.
+*/
+static void
+_serf_tide(FILE* fil_u)
+{
+  c3_w    tid_w[u3m_tides];
+  c3_w    low_w, hig_w, cen_w, i_w;
+  u3_post gar_p;
+
+  u3m_water(&low_w, &hig_w);
+  u3m_tide(tid_w);
+  cen_w = u3e_guard(&gar_p);
+
+  u3a_print_memory(fil_u, "loom: heap", low_w);
+  u3a_print_memory(fil_u, "loom: stack", hig_w);
+  u3a_print_memory(fil_u, "loom: contiguous free", u3a_open(u3R));
+
+  for ( i_w = 0; i_w < u3m_tides; i_w++ ) {
+    if ( 0xffffffff != tid_w[i_w] ) {
+      c3_c cap_c[64];
+      snprintf(cap_c, 64, "loom: least free, road depth %u%s",
+               i_w, ( (u3m_tides - 1) == i_w ) ? "+" : "");
+      u3a_print_memory(fil_u, cap_c, tid_w[i_w]);
+    }
+  }
+
+  if ( gar_p ) {
+    fprintf(fil_u, "loom: guard page at 0x%x, recentered %u times\r\n",
+                   gar_p, cen_w);
+  }
+}
+
 /* _serf_grab(): garbage collect, checking for profiling. RETAIN.
 */
 static void
@@ -232,6 +269,7 @@ _serf_grab(u3_noun sac)
     u3a_print_memory(fil_u, "total marked", tot_w);
     u3a_print_memory(fil_u, "free lists", u3a_idle(u3R));
     u3a_print_memory(fil_u, "sweep", u3a_sweep());
+    _serf_tide(fil_u);
 
     fflush(fil_u);
 
@@ -292,6 +330,7 @@ u3_serf_grab(void)
     u3a_print_memory(stderr, "total marked", u3m_mark(stderr));
     u3a_print_memory(stderr, "free lists", u3a_idle(u3R));
     u3a_print_memory(stderr, "sweep", u3a_sweep());
+    _serf_tide(stderr);
     fprintf(stderr, "\r\n");
   }
 
@@ -303,6 +342,10 @@ u3_serf_grab(void)
 void
 u3_serf_post(u3_serf* sef_u)
 {
+  //  free deferred losses, within a pause budget (in boxes)
+  //
+  u3a_flush(1 << 16);
+
   if ( c3y == sef_u->rec_o ) {
     u3m_reclaim();
     sef_u->rec_o = c3n;
@@ -435,13 +478,47 @@ _serf_sure_core(u3_serf* sef_u, u3_noun cor)
 {
   sef_u->dun_d = sef_u->sen_d;
 
-  u3z(u3A->roc);
+  //  the prior kernel is freed later, in u3_serf_post()
+  //
+  u3a_shed(u3A->roc);
   u3A->roc     = cor;
   u3A->eve_d   = sef_u->dun_d;
   sef_u->mug_l = u3r_mug(u3A->roc);
   sef_u->mut_o = c3y;
 }
 
+/* _serf_sure_tide(): warn the daemon if the loom will run out soon.
+**
+**   contiguous free space is sampled at most once a minute; if it is
+**   falling fast enough to be exhausted within fifteen minutes, say so.
+*/
+static void
+_serf_sure_tide(u3_serf* sef_u)
+{
+  c3_w pos_w = u3a_open(u3R);
+  c3_d now_d = (c3_d)time(0);
+
+  if ( !sef_u->tim_d ) {
+    sef_u->fre_w = pos_w;
+    sef_u->tim_d = now_d;
+  }
+  else if ( (now_d - sef_u->tim_d) >= 60 ) {
+    if ( pos_w < sef_u->fre_w ) {
+      c3_d rat_d = (sef_u->fre_w - pos_w) / (now_d - sef_u->tim_d);
+
+      if ( rat_d && ((pos_w / rat_d) < (15 * 60)) ) {
+        u3l_log("serf: loom exhaustion likely in ~%" PRIu64 " minutes "
+                "(%u MB contiguous free)",
+                1 + ((pos_w / rat_d) / 60),
+                pos_w >> 18);
+      }
+    }
+
+    sef_u->fre_w = pos_w;
+    sef_u->tim_d = now_d;
+  }
+}
+
 /* _serf_sure(): event succeeded, save state and process effects.
 */
 static u3_noun
@@ -455,6 +532,7 @@ _serf_sure(u3_serf* sef_u, c3_w pre_w, u3_noun par)
 
   _serf_sure_core(sef_u, u3k(cor));
   vir = _serf_sure_feck(sef_u, pre_w, u3k(vir));
+  _serf_sure_tide(sef_u);
 
   u3z(par);
   return vir;
@@ -546,14 +624,36 @@ static u3_noun
 _serf_work(u3_serf* sef_u, c3_w mil_w, u3_noun job)
 {
   u3_noun gon;
-  c3_w  pre_w = u3a_open(u3R);
+  c3_w  pre_w;
 
   //  event numbers must be continuous
   //
   c3_assert( sef_u->sen_d == sef_u->dun_d);
   sef_u->sen_d++;
 
-  gon = _serf_poke(sef_u, "work", mil_w, job);  // retain
+  //  deferred losses are only freed a budget at a time (u3_serf_post()),
+  //  so drain them all first if free space is short (an eighth of the loom)
+  //
+  if (  (u3_nul != u3R->laz)
+     && (u3a_open(u3R) < (u3C.wor_i >> 3)) )
+  {
+    u3a_flush(0);
+  }
+
+  pre_w = u3a_open(u3R);
+  gon   = _serf_poke(sef_u, "work", mil_w, job);  // retain
+
+  //  and retry an event that ran out of memory while they were pending
+  //
+  if (  (c3__meme == u3h(gon))
+     && (u3_nul != u3R->laz) )
+  {
+    u3z(gon);
+    u3a_flush(0);
+
+    pre_w = u3a_open(u3R);
+    gon   = _serf_poke(sef_u, "work", mil_w, job);  // retain
+  }
 
   //  event accepted
   //
@@ -746,6 +846,10 @@ _serf_play_list(u3_serf* sef_u, u3_noun eve)
 
       _serf_sure_core(sef_u, u3k(cor));
 
+      //  replay is throughput-bound, so don't defer losses
+      //
+      u3a_flush(0);
+
       //  process effects to set u3_serf_post flags
       //
       u3z(_serf_sure_feck(sef_u, pre_w, u3k(vir)));
@@ -782,6 +886,110 @@ _serf_play_list(u3_serf* sef_u, u3_noun eve)
   return u3nc(c3__done, sef_u->mug_l);
 }
 
+/* u3_serf_ring(): map the king's replay ring [nam_c], read-only.
+*/
+c3_o
+u3_serf_ring(u3_serf* sef_u, c3_c* nam_c)
+{
+  c3_i        fid_i = shm_open(nam_c, O_RDONLY, 0);
+  struct stat buf_u;
+  void*       ptr_v;
+
+  if ( -1 == fid_i ) {
+    fprintf(stderr, "serf: ring: shm_open: %s\r\n", strerror(errno));
+    return c3n;
+  }
+
+  if ( fstat(fid_i, &buf_u) || !buf_u.st_size ) {
+    fprintf(stderr, "serf: ring: fstat: %s\r\n", strerror(errno));
+    close(fid_i);
+    return c3n;
+  }
+
+  ptr_v = mmap(0, buf_u.st_size, PROT_READ, MAP_SHARED, fid_i, 0);
+  close(fid_i);
+
+  if ( MAP_FAILED == ptr_v ) {
+    fprintf(stderr, "serf: ring: mmap: %s\r\n", strerror(errno));
+    return c3n;
+  }
+
+  sef_u->rin_y = ptr_v;
+  sef_u->rin_i = buf_u.st_size;
+
+  return c3y;
+}
+
+/* _serf_ring_list(): cue a replay batch directly from the king's ring.
+*/
+static u3_weak
+_serf_ring_list(u3_serf* sef_u, u3_noun rin)
+{
+  u3_noun nam, off, len, cnt;
+  c3_d    off_d, len_d, cnt_d;
+  u3_noun   lit = u3_nul;
+  c3_y*   byt_y;
+  c3_y*   end_y;
+
+  if (  (c3n == u3r_qual(rin, &nam, &off, &len, &cnt))
+     || (c3n == u3r_safe_chub(off, &off_d))
+     || (c3n == u3r_safe_chub(len, &len_d))
+     || (c3n == u3r_safe_chub(cnt, &cnt_d))
+     || (c3n == u3a_is_atom(nam)) )
+  {
+    return u3_none;
+  }
+
+  //  the ring is mapped at startup, and only used if that worked
+  //
+  if ( !sef_u->rin_y ) {
+    fprintf(stderr, "serf: ring: not mapped\r\n");
+    return u3_none;
+  }
+
+  if ( (off_d > sef_u->rin_i) || (len_d > (sef_u->rin_i - off_d)) ) {
+    fprintf(stderr, "serf: ring: batch out of bounds\r\n");
+    return u3_none;
+  }
+
+  if ( !sef_u->sil_u ) {
+    sef_u->sil_u = u3s_cue_xeno_init();
+  }
+
+  byt_y = sef_u->rin_y + off_d;
+  end_y = byt_y + len_d;
+
+  while ( cnt_d-- ) {
+    c3_d    jam_d = 0;
+    u3_weak   job;
+    c3_w      i_w;
+
+    if ( 8 > (end_y - byt_y) ) {
+      u3z(lit);
+      return u3_none;
+    }
+
+    for ( i_w = 0; i_w < 8; i_w++ ) {
+      jam_d |= (c3_d)byt_y[i_w] << (8 * i_w);
+    }
+
+    byt_y += 8;
+
+    if (  (jam_d > (c3_d)(end_y - byt_y))
+       || (u3_none == (job = u3s_cue_xeno_with(sef_u->sil_u, jam_d, byt_y))) )
+    {
+      fprintf(stderr, "serf: ring: invalid event\r\n");
+      u3z(lit);
+      return u3_none;
+    }
+
+    lit    = u3nc(job, lit);
+    byt_y += jam_d;
+  }
+
+  return u3kb_flop(lit);
+}
+
 /* u3_serf_play(): apply event list, producing status.
 */
 u3_noun
@@ -801,7 +1009,7 @@ u3_serf_play(u3_serf* sef_u, c3_d eve_d, u3_noun lit)
 u3_noun
 u3_serf_peek(u3_serf* sef_u, c3_w mil_w, u3_noun sam)
 {
-  u3_noun gon = u3m_soft(mil_w, u3v_peek, sam);
+  u3_noun gon = u3m_soft_lite(mil_w, u3v_peek, sam);
   u3_noun pro;
 
   {
@@ -886,6 +1094,33 @@ _serf_writ_live_save(u3_serf* sef_u, c3_d eve_d)
   u3e_save();
 }
 
+/* _serf_pack_need(): yes if the home road is worth compacting.
+**
+**   the daemon asks for this on idle (with --auto-pack), at most every
+**   few minutes; pack only once a quarter of the heap (and at least 4MB)
+**   is sitting on the free lists. the pack stops the world for time
+**   proportional to the heap, so skip it if the heap exceeds [max_w] MB.
+*/
+static c3_o
+_serf_pack_need(c3_w max_w)
+{
+  c3_w hep_w = u3a_heap(u3R);
+  c3_w fre_w = u3a_idle(u3R);
+
+  if ( (fre_w < (1 << 20)) || (fre_w <= (hep_w >> 2)) ) {
+    return c3n;
+  }
+
+  //  heap words, in MB
+  //
+  if ( (hep_w >> 18) >= max_w ) {
+    u3a_print_memory(stderr, "serf: pack: auto: skipped, heap", hep_w);
+    return c3n;
+  }
+
+  return c3y;
+}
+
 /* u3_serf_live(): apply %live command [com], producing *ret on c3y.
 */
 c3_o
@@ -962,16 +1197,36 @@ u3_serf_live(u3_serf* sef_u, u3_noun com, u3_noun* ret)
     }
 
     case c3__pack: {
-      if ( u3_nul != dat ) {
+      c3_w max_w;
+
+      if ( u3_nul == dat ) {
         u3z(com);
-        return c3n;
+        u3a_print_memory(stderr, "serf: pack: gained", u3m_pack());
+        *ret = u3nc(c3__live, u3_nul);
+        return c3y;
       }
-      else {
+      //  [%auto max=@ud]: pack only if the free lists have grown large,
+      //  and the heap is under [max] MB
+      //
+      else if (  (c3y == u3du(dat))
+              && (c3__auto == u3h(dat))
+              && (c3y == u3r_safe_word(u3t(dat), &max_w)) )
+      {
         u3z(com);
-        u3a_print_memory(stderr, "serf: pack: gained", u3m_pack());
+
+        if ( c3y == _serf_pack_need(max_w) ) {
+          u3a_print_memory(stderr, "serf: pack: auto: packing, heap",
+                           u3a_heap(u3R));
+          u3a_print_memory(stderr, "serf: pack: auto: gained", u3m_pack());
+        }
+
         *ret = u3nc(c3__live, u3_nul);
         return c3y;
       }
+      else {
+        u3z(com);
+        return c3n;
+      }
     }
 
     case c3__meld: {
@@ -1053,6 +1308,19 @@ u3_serf_writ(u3_serf* sef_u, u3_noun wit, u3_noun* pel)
         {
           ret_o = c3n;
         }
+        //  events passed through shared memory, as stored
+        //
+        else if ( c3__ring == u3h(lit) ) {
+          u3_weak lis = _serf_ring_list(sef_u, u3t(lit));
+
+          if ( u3_none == lis ) {
+            ret_o = c3n;
+          }
+          else {
+            *pel = u3_serf_play(sef_u, eve_d, lis);
+            ret_o = c3y;
+          }
+        }
         else {
           *pel = u3_serf_play(sef_u, eve_d, u3k(lit));
           ret_o = c3y;
@@ -1080,7 +1348,7 @@ u3_serf_writ(u3_serf* sef_u, u3_noun wit, u3_noun* pel)
   return ret_o;
 }
 
-/* _serf_ripe(): produce initial serf state as [eve=@ mug=@]
+/* _serf_ripe(): produce initial serf state as [eve=@ mug=@ rin=?]
 */
 static u3_noun
 _serf_ripe(u3_serf* sef_u)
@@ -1091,7 +1359,9 @@ _serf_ripe(u3_serf* sef_u)
                  ? 0
                  : u3r_mug(u3A->roc);
 
-  return u3nc(u3i_chubs(1, &sef_u->dun_d), sef_u->mug_l);
+  return u3nt(u3i_chubs(1, &sef_u->dun_d),
+              sef_u->mug_l,
+              __(0 != sef_u->rin_y));
 }
 
 /* u3_serf_init(): init or restore, producing status.
@@ -1128,6 +1398,8 @@ u3_serf_init(u3_serf* sef_u)
   sef_u->rec_o = c3n;
   sef_u->mut_o = c3n;
   sef_u->sac   = u3_nul;
+  sef_u->fre_w = 0;
+  sef_u->tim_d = 0;
 
   return rip;
 }
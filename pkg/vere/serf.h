@@ -15,6 +15,11 @@
         c3_o    rec_o;             //  reclaim cache
         c3_o    mut_o;             //  mutated kerne
         u3_noun sac;               //  space measurementl
+        c3_w    fre_w;             //  free space at last sample
+        c3_d    tim_d;             //  time of last sample (seconds)
+        c3_y*   rin_y;             //  replay ring (king's)
+        size_t  rin_i;             //  replay ring size
+        u3_cue_xeno* sil_u;        //  replay ring cue handle
         void  (*xit_f)(void);      //  exit callback
       } u3_serf;
 
@@ -25,6 +30,11 @@
       u3_noun
       u3_serf_init(u3_serf* sef_u);
 
+    /* u3_serf_ring(): map the king's replay ring [nam_c], read-only.
+    */
+      c3_o
+      u3_serf_ring(u3_serf* sef_u, c3_c* nam_c);
+
     /* u3_serf_writ(): apply writ [wit], producing plea [*pel] on c3y.
     */
       c3_o
@@ -280,6 +280,11 @@
         c3_c*   key_c;                      //  -k, private key file
         c3_o    net;                        //  -L, local-only networking
         c3_o    lit;                        //  -l, lite mode
+        c3_o    laz;                        //      demand-paged loom
+        c3_o    sof;                        //      soft-dirty page tracking
+        c3_w    gra_w;                      //      dirty-tracking page (KB)
+        c3_o    out;                        //      page out cold loom memory
+        c3_w    pac_w;                      //      auto-pack heap cap (MB)
         c3_y    lom_y;                      //      loom bex
         c3_y    lut_y;                      //      urth-loom bex
         c3_c*   til_c;                      //  -n, play till eve_d
@@ -303,6 +308,10 @@
         c3_c*   puf_c;                      //  -Z, scry result format
         c3_o    con;                        //      run conn
         c3_o    doc;                        //      dock binary in pier
+        c3_w    pre_w;                      //      replay reads in flight
+        c3_w    cod_w;                      //      group-commit delay (ms)
+        c3_w    coe_w;                      //      group-commit events
+        c3_y    syn_y;                      //      commit sync policy
       } u3_opts;
 
     /* u3_host: entire host.
@@ -372,7 +381,9 @@
         typedef struct _u3_fact {
           c3_d             eve_d;               //  event number
           c3_l             mug_l;               //  kernel mug after
-          u3_noun            job;               //  (pair date ovum)
+          u3_noun            job;               //  (pair date ovum), or none
+          c3_y*            byt_y;               //  [mug:4 jam], if not cued
+          size_t           siz_i;               //  length of byt_y
           struct _u3_fact* nex_u;               //  next in queue
         } u3_fact;
 
@@ -439,7 +450,8 @@
           u3_writ_cram = 4,
           u3_writ_meld = 5,
           u3_writ_pack = 6,
-          u3_writ_exit = 7
+          u3_writ_exit = 7,
+          u3_writ_tidy = 8
         } u3_writ_type;
 
       /* u3_writ: ipc message from king to serf
@@ -456,6 +468,8 @@
             u3_info        fon_u;               //  recompute
             c3_d           eve_d;               //  save/pack at
           };
+          c3_o             rin_o;               //  sent via ring
+          c3_d             rin_d;               //  ring offset
         } u3_writ;
 
       /* u3_lord_cb: u3_lord callbacks
@@ -476,6 +490,20 @@
           void (*exit_f)(void*);
         } u3_lord_cb;
 
+      /* u3_ring: shared-memory ring for replay batches.
+      **
+      **   batches are allocated contiguously, and released in order.
+      */
+        typedef struct _u3_ring {
+          c3_c*            nam_c;               //  shm name
+          c3_o             lin_o;               //  name still linked
+          c3_y*            buf_y;               //  mapping (or 0)
+          c3_d             siz_d;               //  mapping size
+          c3_d             hed_d;               //  next free offset
+          c3_d             tal_d;               //  oldest used offset
+          c3_w             out_w;               //  batches outstanding
+        } u3_ring;
+
       /* u3_lord: serf controller.
       */
         typedef struct _u3_lord {
@@ -499,6 +527,7 @@
           u3_lord_cb            cb_u;           //  callbacks
           c3_o                 pin_o;           //  spinning
           c3_w                 dep_w;           //  queue depth
+          u3_ring              rin_u;           //  replay ring
           struct _u3_writ*     ent_u;           //  queue entry
           struct _u3_writ*     ext_u;           //  queue exit
         } u3_lord;
@@ -506,19 +535,49 @@
       /* u3_read: event log read request
       */
         typedef struct _u3_read {
-          union {                               //  read timer/handle
-            uv_timer_t  tim_u;                  //
+          union {                               //  decode idler/handle
+            uv_idle_t   idl_u;                  //
             uv_handle_t had_u;                  //
           };                                    //
+          union {                               //  read thread/request
+            uv_work_t      ted_u;               //
+            uv_req_t       req_u;               //
+          };                                    //
+          c3_o             ted_o;               //  c3y == active
+          c3_o             can_o;               //  c3y == cancelled
+          c3_o             ret_o;               //  thread result
+          c3_o             don_o;               //  c3y == awaiting delivery
+          c3_o             raw_o;               //  c3y == deliver uncued
           c3_d             eve_d;               //  first event
           c3_d             len_d;               //  read stride
+          size_t           raw_i;               //  bytes read
+          c3_d             cur_d;               //  events decoded
+          c3_d             red_d;               //  events read
+          c3_d             fir_d;               //  first v2 event
+          c3_y*            dic_y;               //  deflate dictionary
+          size_t           dic_i;               //  dictionary length
+          c3_y**           byt_y;               //  raw events (off-loom)
+          size_t*          siz_i;               //  raw event lengths
           struct _u3_fact* ent_u;               //  response entry
           struct _u3_fact* ext_u;               //  response exit
           struct _u3_read* nex_u;               //  next read
           struct _u3_read* pre_u;               //  previous read
           struct _u3_disk* log_u;               //  disk backpointer
+          struct _u3_epoc* epo_u;               //  epoch
+          void*            mdb_u;               //  epoch environment
+          u3_lmdb_scan*    sca_u;               //  cursor (owned)
         } u3_read;
 
+      /* u3_epoc: event log epoch, events after [epo_d].
+      */
+        typedef struct _u3_epoc {
+          c3_d             epo_d;               //  last event before
+          void*            mdb_u;               //  lmdb environment (or 0)
+          u3_lmdb_scan*    sca_u;               //  idle read cursor (or 0)
+          c3_d             fir_d;               //  first v2 event
+          struct _u3_epoc* nex_u;               //  next (later) epoch
+        } u3_epoc;
+
       /* u3_disk_cb: u3_disk callbacks
       */
         typedef struct _u3_disk_cb {
@@ -537,6 +596,8 @@
           u3_dire*         com_u;               //  log directory
           c3_o             liv_o;               //  live
           void*            mdb_u;               //  lmdb environment.
+          u3_epoc*         epo_u;               //  epochs, oldest first
+          c3_d             epo_d;               //  current epoch
           c3_d             sen_d;               //  commit requested
           c3_d             dun_d;               //  committed
           u3_disk_cb        cb_u;               //  callbacks
@@ -547,6 +608,27 @@
           };                                    //
           c3_o             ted_o;               //  c3y == active
           u3_info          put_u;               //  write queue
+          struct {                              //  group commit:
+            uv_timer_t*    tim_u;               //    delay timer
+            c3_o           due_o;               //    c3y == delay expired
+            c3_w           del_w;               //    max delay (ms)
+            c3_d           max_d;               //    commit at (events)
+            c3_y           syn_y;               //    sync policy
+            c3_d           bat_d;               //    batches committed
+            c3_d           eve_d;               //    events committed
+            c3_d           big_d;               //    largest batch
+            c3_d           dep_d;               //    deepest queue
+            c3_d           syn_d;               //    total save time (us)
+            c3_d           sym_d;               //    slowest save (us)
+          } gru_u;                              //
+          struct {                              //  value format:
+            c3_w           ver_w;               //    version
+            c3_d           fir_d;               //    first v2 event
+            c3_y*          dic_y;               //    deflate dictionary
+            size_t         dic_i;               //    dictionary length
+            c3_o           tra_o;               //    c3y == training
+            c3_d           tri_d;               //    next training at
+          } fom_u;                              //
         } u3_disk;
 
       /* u3_psat: pier state.
@@ -573,7 +655,17 @@
         typedef struct _u3_play {
           c3_d             eve_d;               //  target
           c3_d             req_d;               //  last read requested
+          c3_d             las_d;               //  last event requested
+          c3_w             inf_w;               //  reads in flight
           c3_d             sen_d;               //  last sent
+          c3_d             bat_d;               //  batch size
+          c3_o             fix_o;               //  batch size fixed
+          c3_w             fly_w;               //  batches in flight
+          c3_d             tim_d;               //  serf busy since (ns)
+          c3_d             per_d;               //  serf ns per event
+          c3_o             sav_o;               //  snapshot pending
+          c3_d             sav_d;               //  last snapshot (ns)
+          c3_d             cos_d;               //  last snapshot cost (ns)
           u3_fact*         ent_u;               //  queue entry
           u3_fact*         ext_u;               //  queue exit
           struct _u3_pier* pir_u;               //  pier backpointer
@@ -624,6 +716,7 @@
           uv_prepare_t     pep_u;               //  pre-loop
           uv_check_t       cek_u;               //  post-loop
           uv_idle_t        idl_u;               //  catchall XX uv_async_t?
+          c3_d             tid_d;               //  last idle pack (ms)
           struct _u3_pier* pir_u;               //  pier backpointer
         } u3_work;
 
@@ -785,6 +878,11 @@
         void
         u3_fact_free(u3_fact *tac_u);
 
+      /* u3_fact_cue(): decode event, if not yet cued.
+      */
+        u3_noun
+        u3_fact_cue(u3_fact *tac_u);
+
       /* u3_gift_init(): initialize effect list.
       */
         u3_gift*
@@ -959,10 +1057,53 @@
                           c3_o     fak_o,
                           c3_w     lif_w);
 
-      /* u3_disk_read(): read [len_d] events starting at [eve_d].
+      /* u3_disk_save_format(): save value format of [log_u] into [mdb_u],
+      **                        for a log beginning at [eve_d].
       */
-        void
-        u3_disk_read(u3_disk* log_u, c3_d eve_d, c3_d len_d);
+        c3_o
+        u3_disk_save_format(u3_disk* log_u, MDB_env* mdb_u, c3_d eve_d);
+
+      /* u3_disk_roll(): start a new epoch after snapshot at [eve_d].
+      */
+        c3_o
+        u3_disk_roll(u3_disk* log_u, c3_d eve_d);
+
+      /* u3_disk_chop(): delete epochs ending at or before [eve_d],
+      **                 but for the last of them.
+      */
+        c3_o
+        u3_disk_chop(u3_disk* log_u, c3_d eve_d);
+
+      /* u3_disk_index(): look up the mug and sizes of event [eve_d],
+      **                  from the index if present, without decoding it.
+      */
+        c3_o
+        u3_disk_index(u3_disk* log_u,
+                      c3_d     eve_d,
+                      c3_l*    mug_l,
+                      c3_d*    len_d,
+                      c3_d*    siz_d,
+                      c3_o*    dex_o);
+
+      /* u3_disk_scan(): verify events [eve_d, las_d] against the index,
+      **                 across [thr_w] threads, optionally indexing the
+      **                 unindexed.
+      */
+        c3_o
+        u3_disk_scan(u3_disk* log_u,
+                     c3_d     eve_d,
+                     c3_d     las_d,
+                     c3_w     thr_w,
+                     c3_o     fix_o);
+
+      /* u3_disk_read(): read up to [len_d] events starting at [eve_d],
+      **                 producing the number requested.
+      **
+      **   reads do not span epochs, and are delivered in request order.
+      **   if [raw_o], events are delivered as stored, without a cue.
+      */
+        c3_d
+        u3_disk_read(u3_disk* log_u, c3_d eve_d, c3_d len_d, c3_o raw_o);
 
       /* u3_disk_boot_plan(): enqueue boot sequence, without autocommit.
       */
@@ -1032,6 +1173,11 @@
         void
         u3_lord_pack(u3_lord* god_u);
 
+      /* u3_lord_tidy(): defragment persistent state, if fragmented.
+      */
+        void
+        u3_lord_tidy(u3_lord* god_u);
+
       /* u3_lord_work(): attempt work.
       */
         void
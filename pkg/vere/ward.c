@@ -75,6 +75,8 @@ u3_fact_init(c3_d eve_d, c3_l mug_l, u3_noun job)
   tac_u->mug_l = mug_l;
   tac_u->nex_u = 0;
   tac_u->job   = job;
+  tac_u->byt_y = 0;
+  tac_u->siz_i = 0;
 
   return tac_u;
 }
@@ -84,10 +86,34 @@ u3_fact_init(c3_d eve_d, c3_l mug_l, u3_noun job)
 void
 u3_fact_free(u3_fact *tac_u)
 {
-  u3z(tac_u->job);
+  if ( u3_none != tac_u->job ) {
+    u3z(tac_u->job);
+  }
+
+  c3_free(tac_u->byt_y);
   c3_free(tac_u);
 }
 
+/* u3_fact_cue(): decode event, if not yet cued.
+*/
+u3_noun
+u3_fact_cue(u3_fact *tac_u)
+{
+  if ( u3_none == tac_u->job ) {
+    c3_assert( tac_u->byt_y && (4 < tac_u->siz_i) );
+
+    //  XX u3m_soft?
+    //
+    tac_u->job = u3ke_cue(u3i_bytes(tac_u->siz_i - 4, tac_u->byt_y + 4));
+
+    c3_free(tac_u->byt_y);
+    tac_u->byt_y = 0;
+    tac_u->siz_i = 0;
+  }
+
+  return tac_u->job;
+}
+
 /* u3_gift_init(): initialize effect list.
 */
 u3_gift*